@@ -7,6 +7,7 @@ import 'dart:io';
 import 'dart:async';
 import 'package:flutter/widgets.dart';
 import 'package:flutter/services.dart';
+import 'package:flutter/rendering.dart';
 import 'package:media_kit_video/media_kit_video_controls/media_kit_video_controls.dart';
 
 import 'package:media_kit_video/src/subtitle/subtitle_view.dart';
@@ -151,6 +152,18 @@ class VideoState extends State<Video> with WidgetsBindingObserver {
   late int? _width = widget.controller.player.state.width;
   late int? _height = widget.controller.player.state.height;
   late bool _visible = (_width ?? 0) > 0 && (_height ?? 0) > 0;
+  // Size of the viewport, its device pixel ratio, fit & alignment; used to compute the size at which the video output is displayed & its visible region.
+  Size? _viewport;
+  double _devicePixelRatio = 1.0;
+  BoxFit _fit = BoxFit.contain;
+  Alignment _alignment = Alignment.center;
+  double? _aspectRatio;
+  Size? _displaySize;
+  Rect? _crop;
+  // Whether the video output is visible on screen; last reported value & inputs of [_isOnScreen] captured during build.
+  bool? _onScreen;
+  bool _tickerModeEnabled = true;
+  Size? _screenSize;
 
   bool _pauseDueToPauseUponEnteringBackgroundMode = false;
   // Public API:
@@ -317,6 +330,7 @@ class VideoState extends State<Video> with WidgetsBindingObserver {
                 _visible = visible;
               });
             }
+            _updateDisplaySize();
           },
         ),
         widget.controller.player.stream.height.listen(
@@ -328,11 +342,14 @@ class VideoState extends State<Video> with WidgetsBindingObserver {
                 _visible = visible;
               });
             }
+            _updateDisplaySize();
           },
         ),
       ],
     );
     // --------------------------------------------------
+    _updateVisibility();
+    // --------------------------------------------------
     if (widget.wakelock) {
       if (widget.controller.player.state.playing) {
         _wakelock.enable();
@@ -358,6 +375,14 @@ class VideoState extends State<Video> with WidgetsBindingObserver {
     for (final subscription in _subscriptions) {
       subscription.cancel();
     }
+    widget.controller.platform.future.then(
+      (platform) {
+        platform.setVisible(this, null);
+        platform.setDisplaySize(this, null);
+        platform.setCrop(this, null);
+      },
+      onError: (_) {},
+    );
     if (_disposeNotifiers) {
       videoViewParametersNotifier.dispose();
       _contextNotifier.dispose();
@@ -369,8 +394,120 @@ class VideoState extends State<Video> with WidgetsBindingObserver {
 
   void refreshView() {}
 
+  /// Reports the size (in physical pixels) at which the video output is displayed & its region visible in the viewport to the [PlatformVideoController].
+  /// The native implementation may use it to render the video output at a smaller size than the video's resolution & only the visible region.
+  void _updateDisplaySize() {
+    final viewport = _viewport;
+    final width = _width;
+    final height = _height;
+    if (viewport == null ||
+        !viewport.isFinite ||
+        viewport.isEmpty ||
+        width == null ||
+        height == null ||
+        width <= 0 ||
+        height <= 0) {
+      return;
+    }
+    final input = Size(
+      _aspectRatio == null ? width.toDouble() : height * _aspectRatio!,
+      height.toDouble(),
+    );
+    final sizes = applyBoxFit(_fit, input, viewport);
+    final size = sizes.destination * _devicePixelRatio;
+    // Region of the video not clipped by [FittedBox] (e.g. [BoxFit.cover]), normalized.
+    final source = _alignment.inscribe(sizes.source, Offset.zero & input);
+    final crop = Rect.fromLTWH(
+      source.left / input.width,
+      source.top / input.height,
+      source.width / input.width,
+      source.height / input.height,
+    );
+    if (_displaySize == size && _crop == crop) {
+      return;
+    }
+    _displaySize = size;
+    _crop = crop;
+    // Update lazily i.e. once the layout settles.
+    WidgetsBinding.instance.addPostFrameCallback((_) {
+      if (_displaySize != size || _crop != crop) {
+        return;
+      }
+      widget.controller.platform.future.then(
+        (platform) {
+          if (_displaySize == size && _crop == crop) {
+            platform.setDisplaySize(this, size);
+            platform.setCrop(this, crop);
+          }
+        },
+        onError: (_) {},
+      );
+    });
+  }
+
+  /// Reports whether this [Video] is visible on screen to the [PlatformVideoController], which stops rendering new video frames while none of its [Video]s are.
+  /// Re-evaluated after every frame, since e.g. scrolling does not rebuild this [Video].
+  void _updateVisibility() {
+    if (!mounted) {
+      return;
+    }
+    WidgetsBinding.instance.addPostFrameCallback((_) => _updateVisibility());
+    final visible = _isOnScreen();
+    if (_onScreen == visible) {
+      return;
+    }
+    _onScreen = visible;
+    widget.controller.platform.future.then(
+      (platform) {
+        if (mounted && _onScreen == visible) {
+          platform.setVisible(this, visible);
+        }
+      },
+      onError: (_) {},
+    );
+  }
+
+  /// Whether this [Video] is on screen i.e. not offstage (e.g. covered by another route or in an inactive tab) & not scrolled out of an enclosing viewport.
+  bool _isOnScreen() {
+    if (!_tickerModeEnabled) {
+      return false;
+    }
+    final object = context.findRenderObject();
+    if (object is! RenderBox || !object.attached || !object.hasSize) {
+      return false;
+    }
+    var bounds = MatrixUtils.transformRect(
+      object.getTransformTo(null),
+      Offset.zero & object.size,
+    );
+    // Viewports (e.g. [ListView]) do not paint children scrolled out of view, even though these remain laid out within the cache extent.
+    RenderObject? current = object;
+    while (current != null) {
+      final viewport = RenderAbstractViewport.maybeOf(current);
+      if (viewport == null) {
+        break;
+      }
+      if (viewport is RenderBox && viewport.hasSize) {
+        bounds = bounds.intersect(
+          MatrixUtils.transformRect(
+            viewport.getTransformTo(null),
+            Offset.zero & viewport.size,
+          ),
+        );
+      }
+      current = viewport.parent as RenderObject?;
+    }
+    final screen = _screenSize;
+    if (screen != null) {
+      bounds = bounds.intersect(Offset.zero & screen);
+    }
+    return bounds.width > 0.0 && bounds.height > 0.0;
+  }
+
   @override
   Widget build(BuildContext context) {
+    _tickerModeEnabled = TickerMode.of(context);
+    _screenSize = MediaQuery.maybeSizeOf(context);
     return media_kit_video_controls.VideoStateInheritedWidget(
       state: this as dynamic,
       contextNotifier: _contextNotifier,
@@ -386,66 +523,112 @@ class VideoState extends State<Video> with WidgetsBindingObserver {
             child: Stack(
               fit: StackFit.expand,
               children: [
-                ClipRect(
-                  child: FittedBox(
-                    fit: videoViewParameters.fit,
-                    alignment: videoViewParameters.alignment,
-                    child: ValueListenableBuilder<PlatformVideoController?>(
-                      valueListenable: widget.controller.notifier,
-                      builder: (context, notifier, _) => notifier == null
-                          ? const SizedBox.shrink()
-                          : ValueListenableBuilder<int?>(
-                              valueListenable: notifier.id,
-                              builder: (context, id, _) {
-                                return ValueListenableBuilder<Rect?>(
-                                  valueListenable: notifier.rect,
-                                  builder: (context, rect, _) {
-                                    if (id != null &&
-                                        rect != null &&
-                                        _visible) {
-                                      return SizedBox(
-                                        // Apply aspect ratio if provided.
-                                        width:
-                                            videoViewParameters.aspectRatio ==
-                                                    null
-                                                ? rect.width
-                                                : rect.height *
-                                                    videoViewParameters
-                                                        .aspectRatio!,
-                                        height: rect.height,
-                                        child: Stack(
-                                          children: [
-                                            const SizedBox(),
-                                            Positioned.fill(
-                                              child: Texture(
-                                                textureId: id,
-                                                filterQuality:
-                                                    videoViewParameters
-                                                        .filterQuality,
-                                              ),
-                                            ),
-                                            // Keep the |Texture| hidden before the first frame renders. In native implementation, if no default frame size is passed (through VideoController), a starting 1 pixel sized texture/surface is created to initialize the render context & check for H/W support.
-                                            // This is then resized based on the video dimensions & accordingly texture ID, texture, EGLDisplay, EGLSurface etc. (depending upon platform) are also changed. Just don't show that 1 pixel texture to the UI.
-                                            // NOTE: Unmounting |Texture| causes the |MarkTextureFrameAvailable| to not do anything on GNU/Linux.
-                                            if (rect.width <= 1.0 &&
-                                                rect.height <= 1.0)
-                                              Positioned.fill(
-                                                child: Container(
-                                                  color:
-                                                      videoViewParameters.fill,
+                LayoutBuilder(
+                  builder: (context, constraints) {
+                    _viewport = constraints.biggest;
+                    _devicePixelRatio =
+                        MediaQuery.maybeDevicePixelRatioOf(context) ?? 1.0;
+                    _fit = videoViewParameters.fit;
+                    _alignment = videoViewParameters.alignment
+                        .resolve(Directionality.maybeOf(context));
+                    _aspectRatio = videoViewParameters.aspectRatio;
+                    _updateDisplaySize();
+                    return ClipRect(
+                      child: FittedBox(
+                        fit: videoViewParameters.fit,
+                        alignment: videoViewParameters.alignment,
+                        child: ValueListenableBuilder<PlatformVideoController?>(
+                          valueListenable: widget.controller.notifier,
+                          builder: (context, notifier, _) => notifier == null
+                              ? const SizedBox.shrink()
+                              : ValueListenableBuilder<int?>(
+                                  valueListenable: notifier.id,
+                                  builder: (context, id, _) {
+                                    return ValueListenableBuilder<Rect?>(
+                                      valueListenable: notifier.rect,
+                                      builder: (context, rect, _) {
+                                        if (id != null &&
+                                            rect != null &&
+                                            _visible) {
+                                          return ValueListenableBuilder<Rect?>(
+                                            valueListenable: notifier.crop,
+                                            builder: (context, crop, _) {
+                                              // The video output may only contain a region of the video (see [PlatformVideoController.setCrop]). The whole video is laid out & the video output is placed at that region, so that [FittedBox] clips it as if it contained the whole video.
+                                              final region =
+                                                  crop ?? const Rect.fromLTWH(0.0, 0.0, 1.0, 1.0);
+                                              // Apply aspect ratio if provided.
+                                              final height = rect.height / region.height;
+                                              final width =
+                                                  videoViewParameters.aspectRatio == null
+                                                      ? rect.width / region.width
+                                                      : height * videoViewParameters.aspectRatio!;
+                                              return SizedBox(
+                                                width: width,
+                                                height: height,
+                                                child: ValueListenableBuilder<Size?>(
+                                                  valueListenable: notifier.textureSize,
+                                                  builder: (context, textureSize, _) {
+                                                    // The texture may be larger than the video output, which is placed at its top-left. Overflowing part is clipped by the [Stack].
+                                                    final scaleX =
+                                                        textureSize != null && rect.width > 0.0
+                                                            ? textureSize.width / rect.width
+                                                            : 1.0;
+                                                    final scaleY =
+                                                        textureSize != null && rect.height > 0.0
+                                                            ? textureSize.height / rect.height
+                                                            : 1.0;
+                                                    return Stack(
+                                                      children: [
+                                                        const SizedBox(),
+                                                        Positioned(
+                                                          left: region.left * width,
+                                                          top: region.top * height,
+                                                          width: region.width * width,
+                                                          height: region.height * height,
+                                                          child: Stack(
+                                                            children: [
+                                                              Positioned(
+                                                                left: 0.0,
+                                                                top: 0.0,
+                                                                width: region.width * width * scaleX,
+                                                                height: region.height * height * scaleY,
+                                                                child: Texture(
+                                                                  textureId: id,
+                                                                  filterQuality:
+                                                                      videoViewParameters.filterQuality,
+                                                                ),
+                                                              ),
+                                                            ],
+                                                          ),
+                                                        ),
+                                                        // Keep the |Texture| hidden before the first frame renders. In native implementation, if no default frame size is passed (through VideoController), a starting 1 pixel sized texture/surface is created to initialize the render context & check for H/W support.
+                                                        // This is then resized based on the video dimensions & accordingly texture ID, texture, EGLDisplay, EGLSurface etc. (depending upon platform) are also changed. Just don't show that 1 pixel texture to the UI.
+                                                        // NOTE: Unmounting |Texture| causes the |MarkTextureFrameAvailable| to not do anything on GNU/Linux.
+                                                        if (rect.width <= 1.0 &&
+                                                            rect.height <= 1.0)
+                                                          Positioned.fill(
+                                                            child: Container(
+                                                              color: videoViewParameters
+                                                                  .fill,
+                                                            ),
+                                                          ),
+                                                      ],
+                                                    );
+                                                  },
                                                 ),
-                                              ),
-                                          ],
-                                        ),
-                                      );
-                                    }
-                                    return const SizedBox.shrink();
+                                              );
+                                            },
+                                          );
+                                        }
+                                        return const SizedBox.shrink();
+                                      },
+                                    );
                                   },
-                                );
-                              },
-                            ),
-                    ),
-                  ),
+                                ),
+                        ),
+                      ),
+                    );
+                  },
                 ),
                 if (videoViewParameters.subtitleViewConfiguration.visible &&
                     !(widget.controller.player.platform?.configuration.libass ??
@@ -4,6 +4,7 @@
 /// All rights reserved.
 /// Use of this source code is governed by MIT license that can be found in the LICENSE file.
 import 'dart:io';
+import 'dart:math';
 import 'dart:async';
 import 'dart:collection';
 import 'package:flutter/services.dart';
@@ -41,12 +42,33 @@ class NativeVideoController extends PlatformVideoController {
   /// Fixed height of the video output.
   int? height;
 
+  /// Width at which the video output is displayed (from [Video]).
+  int? displayWidth;
+
+  /// Height at which the video output is displayed (from [Video]).
+  int? displayHeight;
+
   /// Width of the video (from [VideoParams]).
   int? videoParamsWidth;
 
   /// Height of the video (from [VideoParams]).
   int? videoParamsHeight;
 
+  /// Sizes (in physical pixels) of the views (e.g. [Video]s) displaying the video output.
+  final _displaySizes = HashMap<Object, Size>();
+
+  /// Visibility of the views (e.g. [Video]s) displaying the video output.
+  final _views = HashMap<Object, bool>();
+
+  /// Visibility last sent to the native implementation.
+  bool _visible = true;
+
+  /// Visible regions of the video in the views (e.g. [Video]s) displaying the video output.
+  final _crops = HashMap<Object, Rect>();
+
+  /// Region of the video last sent to the native implementation. `null` if not cropped.
+  Rect? _crop;
+
   /// [Lock] used to synchronize [onLoadHooks], [onUnloadHooks] & [subscription].
   final lock = Lock();
 
@@ -174,18 +196,36 @@ class NativeVideoController extends PlatformVideoController {
 
     controller.id.addListener(listener);
 
-    await _channel.invokeMethod(
-      'VideoOutputManager.Create',
-      {
-        'handle': handle.toString(),
-        'configuration': {
-          'width': configuration.width.toString(),
-          'height': configuration.height.toString(),
-          'enableHardwareAcceleration':
-              configuration.enableHardwareAcceleration,
+    // Throws [PlatformException] if rejected as per the memory limit (see [setMemoryLimit]).
+    try {
+      await _channel.invokeMethod(
+        'VideoOutputManager.Create',
+        {
+          'handle': handle.toString(),
+          'configuration': {
+            'width': configuration.width.toString(),
+            'height': configuration.height.toString(),
+            'enableHardwareAcceleration':
+                configuration.enableHardwareAcceleration,
+            'sharedRenderContext': configuration.sharedRenderContext,
+            'renderBudget':
+                configuration.renderBudget?.inMicroseconds.toString() ??
+                    'null',
+            'renderFormat': configuration.renderFormat.name,
+            'framePacing': configuration.framePacing,
+            'measureFrameLatency': configuration.measureFrameLatency,
+            'softwareMaxWidth': configuration.softwareMaxWidth.toString(),
+            'softwareMaxHeight': configuration.softwareMaxHeight.toString(),
+            'maxFps': configuration.maxFps?.toString() ?? 'null',
+          },
         },
-      },
-    );
+      );
+    } on PlatformException {
+      controller.id.removeListener(listener);
+      player.platform?.release.remove(controller._dispose);
+      _controllers.remove(handle);
+      rethrow;
+    }
 
     await completer.future;
     controller.id.removeListener(listener);
@@ -235,6 +275,318 @@ class NativeVideoController extends PlatformVideoController {
     }
   }
 
+  /// Sets the size (in physical pixels) at which the video output is displayed in [view].
+  /// The video output is then rendered at most at the largest of these sizes, while maintaining aspect ratio.
+  ///
+  /// Only has an effect on GNU/Linux, if [VideoControllerConfiguration.autoSize] is `true` or [VideoControllerConfiguration.enableHardwareAcceleration] is `false`, & no fixed size is set.
+  @override
+  Future<void> setDisplaySize(Object view, Size? size) async {
+    // Software rendering is always sized to the display (CPU time scales with the pixels rendered).
+    if (!Platform.isLinux ||
+        !(configuration.autoSize ||
+            !configuration.enableHardwareAcceleration)) {
+      return;
+    }
+    if (size == null) {
+      _displaySizes.remove(view);
+    } else {
+      _displaySizes[view] = size;
+    }
+    // Large enough for each of the views.
+    int? width;
+    int? height;
+    for (final e in _displaySizes.values) {
+      width = max(width ?? 0, e.width.ceil());
+      height = max(height ?? 0, e.height.ceil());
+    }
+    // A fixed size (set through [setSize] or [VideoControllerConfiguration]) takes precedence.
+    final fixed = this.width != null && this.height != null;
+    final int? limitWidth = fixed ? null : width;
+    final int? limitHeight = fixed ? null : height;
+    if (displayWidth == limitWidth && displayHeight == limitHeight) {
+      // No need to resize if the requested size is same as the current size.
+      return;
+    }
+    displayWidth = limitWidth;
+    displayHeight = limitHeight;
+    final handle = await player.handle;
+    await _channel.invokeMethod(
+      'VideoOutputManager.SetDisplaySize',
+      {
+        'handle': handle.toString(),
+        'width': limitWidth?.toString() ?? 'null',
+        'height': limitHeight?.toString() ?? 'null',
+      },
+    );
+  }
+
+  /// Sets whether [view] displaying the video output is currently visible.
+  /// While none of the views is visible, the video output does not render new video frames (playback & audio continue) & the newest video frame is rendered once visible again.
+  ///
+  /// Only has an effect on GNU/Linux.
+  @override
+  Future<void> setVisible(Object view, bool? visible) async {
+    if (!Platform.isLinux) {
+      return;
+    }
+    if (visible == null) {
+      _views.remove(view);
+    } else {
+      _views[view] = visible;
+    }
+    // Visible (the default) once no view is registered e.g. all of them were disposed.
+    final value = _views.isEmpty || _views.values.any((e) => e);
+    if (_visible == value) {
+      return;
+    }
+    _visible = value;
+    final handle = await player.handle;
+    await _channel.invokeMethod(
+      'VideoOutputManager.SetVisible',
+      {
+        'handle': handle.toString(),
+        'visible': value.toString(),
+      },
+    );
+  }
+
+  /// Sets the region of the video visible in [view].
+  /// Only the union of the regions visible in the views is rendered, into a correspondingly smaller video output.
+  ///
+  /// Only has an effect on GNU/Linux, if [VideoControllerConfiguration.autoSize] is `true` & no fixed size is set.
+  @override
+  Future<void> setCrop(Object view, Rect? crop) async {
+    if (!Platform.isLinux || !configuration.autoSize) {
+      return;
+    }
+    if (crop == null) {
+      _crops.remove(view);
+    } else {
+      _crops[view] = crop;
+    }
+    Rect? value = _crops.isEmpty
+        ? null
+        : _crops.values.reduce((a, b) => a.expandToInclude(b));
+    // A fixed size (set through [setSize] or [VideoControllerConfiguration]) takes precedence.
+    final fixed = width != null && height != null;
+    // No need to crop (nearly) the whole video.
+    if (fixed ||
+        value == null ||
+        (value.width >= 0.999 && value.height >= 0.999)) {
+      value = null;
+    }
+    if (_crop == value) {
+      return;
+    }
+    _crop = value;
+    final handle = await player.handle;
+    await _channel.invokeMethod(
+      'VideoOutputManager.SetCrop',
+      {
+        'handle': handle.toString(),
+        'left': value?.left.toString() ?? 'null',
+        'top': value?.top.toString() ?? 'null',
+        'width': value?.width.toString() ?? 'null',
+        'height': value?.height.toString() ?? 'null',
+      },
+    );
+  }
+
+  /// Returns render statistics of the video output e.g. performed & skipped render counts.
+  /// `createTime` is the time (in microseconds) taken to create the video output & `firstFrameTime` the time from then until its first frame was presented (`0` until then); `prewarmed` is whether it adopted a pre-warmed render context (see [setPoolSize]).
+  /// With S/W rendering, frames are rendered on a dedicated thread & `averageMainThreadTime` is the time (in microseconds) spent per frame on the GTK main thread.
+  /// `fps` is the achieved rendering frame rate (`0` while no frames are rendered e.g. paused) & `cappedFrames` the number of frames skipped as per [VideoControllerConfiguration.maxFps].
+  ///
+  /// Only available on GNU/Linux. Returns an empty [Map] on other platforms.
+  Future<Map<String, dynamic>> getStatistics() async {
+    if (!Platform.isLinux) {
+      return const {};
+    }
+    final handle = await player.handle;
+    final result = await _channel.invokeMethod(
+      'VideoOutputManager.GetStatistics',
+      {
+        'handle': handle.toString(),
+      },
+    );
+    return Map<String, dynamic>.from(result ?? const {});
+  }
+
+  /// Returns 50th, 95th & 99th percentiles (in microseconds) of the time spent by recent video frames in each stage of the native pipeline: `queue`, `render`, `flush`, `mark`, `present` & `total`.
+  ///
+  /// Only available on GNU/Linux with [VideoControllerConfiguration.measureFrameLatency]. Returns an empty [Map] otherwise.
+  Future<Map<String, dynamic>> getFrameLatency() async {
+    if (!Platform.isLinux) {
+      return const {};
+    }
+    final handle = await player.handle;
+    final result = await _channel.invokeMethod(
+      'VideoOutputManager.GetFrameLatency',
+      {
+        'handle': handle.toString(),
+      },
+    );
+    return Map<String, dynamic>.from(result ?? const {});
+  }
+
+  /// Creates an additional texture showing the same video output, without decoding or rendering it again.
+  /// The returned texture ID may be displayed using a [Texture] widget, sized as per [rect].
+  ///
+  /// Only available on GNU/Linux with hardware acceleration. Returns `null` otherwise.
+  Future<int?> createMirror() async {
+    if (!Platform.isLinux) {
+      return null;
+    }
+    final handle = await player.handle;
+    final int? id = await _channel.invokeMethod(
+      'VideoOutputManager.CreateMirror',
+      {
+        'handle': handle.toString(),
+      },
+    );
+    return id;
+  }
+
+  /// Disposes a texture created through [createMirror].
+  Future<void> disposeMirror(int id) async {
+    if (!Platform.isLinux) {
+      return;
+    }
+    final handle = await player.handle;
+    await _channel.invokeMethod(
+      'VideoOutputManager.DisposeMirror',
+      {
+        'handle': handle.toString(),
+        'id': id.toString(),
+      },
+    );
+  }
+
+  /// Limits the memory (in bytes) held by all video outputs i.e. render targets, S/W pixel buffers & mosaic textures.
+  /// The limit is enforced when new [VideoController]s are created: the video output is rejected (creation throws [PlatformException]) or, with [downsize], rendered at a size fitting the remaining memory.
+  /// Existing video outputs are not affected. Pass `null` to remove the limit.
+  ///
+  /// Only available on GNU/Linux.
+  static Future<void> setMemoryLimit(int? limit, {bool downsize = false}) async {
+    if (!Platform.isLinux) {
+      return;
+    }
+    await _channel.invokeMethod(
+      'VideoOutputManager.SetMemoryLimit',
+      {
+        'limit': limit.toString(),
+        'policy': downsize ? 'downsize' : 'reject',
+      },
+    );
+  }
+
+  /// Sets the number of pre-warmed render contexts (render thread, EGL context & registered texture) kept ready for new [VideoController]s.
+  /// New video outputs adopt one instead of initializing it, which reduces the time until the [VideoController] is created & its first frame is rendered (see [PlatformVideoController.waitUntilFirstFrameRendered]) e.g. when frequently switching between [Player]s. Adopted render contexts are replaced in the background.
+  /// Not used with [VideoControllerConfiguration.sharedRenderContext] or S/W rendering. Pass `0` to release the pool.
+  ///
+  /// Only available on GNU/Linux.
+  static Future<void> setPoolSize(int size) async {
+    if (!Platform.isLinux) {
+      return;
+    }
+    await _channel.invokeMethod(
+      'VideoOutputManager.SetPoolSize',
+      {
+        'size': size.toString(),
+      },
+    );
+  }
+
+  /// Returns the memory (in bytes) held by all video outputs, per [Player] handle & by mosaics, its high-water mark & the memory limit.
+  /// Also reports the process-wide pool of released software rendering pixel buffers kept for reuse (`pixelBufferPool`), which is not counted in `memory`.
+  ///
+  /// Only available on GNU/Linux. Returns an empty [Map] on other platforms.
+  static Future<Map<String, dynamic>> getMemoryStatistics() async {
+    if (!Platform.isLinux) {
+      return const {};
+    }
+    final result = await _channel.invokeMethod(
+      'VideoOutputManager.GetMemoryStatistics',
+    );
+    return Map<String, dynamic>.from(result ?? const {});
+  }
+
+  /// Creates a single [width] x [height] texture composing the video outputs of multiple [Player]s (tiles) e.g. for video walls.
+  /// Flutter composites a single texture instead of one per [Player]. Tiles are only copied into the mosaic when their [Player] renders a new frame.
+  /// The returned texture ID may be displayed using a [Texture] widget. Tiles are assigned using [setMosaicLayout].
+  ///
+  /// Only available on GNU/Linux. Tiles require hardware acceleration & [VideoControllerConfiguration.sharedRenderContext]. Returns `null` otherwise.
+  static Future<int?> createMosaic(int width, int height) async {
+    if (!Platform.isLinux) {
+      return null;
+    }
+    final int? id = await _channel.invokeMethod(
+      'VideoOutputManager.CreateMosaic',
+      {
+        'width': width.toString(),
+        'height': height.toString(),
+      },
+    );
+    return id;
+  }
+
+  /// Sets the tiles of the mosaic created using [createMosaic]: the [Rect] (in pixels of the mosaic) of each [Player]'s video output.
+  /// Video frames are fitted inside their [Rect], maintaining aspect ratio. May be called again at any time to update the layout.
+  ///
+  /// Throws a [PlatformException] (code `MosaicTilesRejected`, with the rejected [Player.handle]s as details) if some of the tiles cannot be composed e.g. their video output is not rendered on the mosaic's render thread (see [VideoControllerConfiguration.sharedRenderContext]), uses software rendering or a floating point format. The remaining tiles are composed.
+  static Future<void> setMosaicLayout(int id, Map<Player, Rect> tiles) async {
+    if (!Platform.isLinux) {
+      return;
+    }
+    final layout = <Map<String, String>>[];
+    for (final entry in tiles.entries) {
+      final handle = await entry.key.handle;
+      layout.add(
+        {
+          'handle': handle.toString(),
+          'left': entry.value.left.round().toString(),
+          'top': entry.value.top.round().toString(),
+          'width': entry.value.width.round().toString(),
+          'height': entry.value.height.round().toString(),
+        },
+      );
+    }
+    await _channel.invokeMethod(
+      'VideoOutputManager.SetMosaicLayout',
+      {
+        'id': id.toString(),
+        'tiles': layout,
+      },
+    );
+  }
+
+  /// Returns composition statistics of the mosaic created using [createMosaic] e.g. composed frame & copied tile counts.
+  static Future<Map<String, dynamic>> getMosaicStatistics(int id) async {
+    if (!Platform.isLinux) {
+      return const {};
+    }
+    final result = await _channel.invokeMethod(
+      'VideoOutputManager.GetMosaicStatistics',
+      {
+        'id': id.toString(),
+      },
+    );
+    return Map<String, dynamic>.from(result ?? const {});
+  }
+
+  /// Disposes a mosaic created using [createMosaic].
+  static Future<void> disposeMosaic(int id) async {
+    if (!Platform.isLinux) {
+      return;
+    }
+    await _channel.invokeMethod(
+      'VideoOutputManager.DisposeMosaic',
+      {
+        'id': id.toString(),
+      },
+    );
+  }
+
   /// Disposes the instance. Releases allocated resources back to the system.
   Future<void> _dispose() async {
     super.dispose();
@@ -273,6 +625,26 @@ class NativeVideoController extends PlatformVideoController {
                       call.arguments['rect']['height'] * 1.0,
                     );
                     final int id = call.arguments['id'];
+                    final int? textureWidth = call.arguments['textureWidth'];
+                    final int? textureHeight = call.arguments['textureHeight'];
+                    _controllers[handle]?.textureSize.value =
+                        textureWidth != null &&
+                                textureHeight != null &&
+                                (textureWidth != rect.width ||
+                                    textureHeight != rect.height)
+                            ? Size(textureWidth * 1.0, textureHeight * 1.0)
+                            : null;
+                    final double? scale = call.arguments['scale'];
+                    _controllers[handle]?.renderScale.value = scale ?? 1.0;
+                    final crop = call.arguments['crop'];
+                    _controllers[handle]?.crop.value = crop == null
+                        ? null
+                        : Rect.fromLTWH(
+                            crop['left'] * 1.0,
+                            crop['top'] * 1.0,
+                            crop['width'] * 1.0,
+                            crop['height'] * 1.0,
+                          );
                     _controllers[handle]?.rect.value = rect;
                     _controllers[handle]?.id.value = id;
                     // Notify about the first frame being rendered.
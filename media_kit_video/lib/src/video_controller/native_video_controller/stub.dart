@@ -3,6 +3,7 @@
 /// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
 /// All rights reserved.
 /// Use of this source code is governed by MIT license that can be found in the LICENSE file.
+import 'package:flutter/widgets.dart';
 import 'package:media_kit/media_kit.dart';
 
 import 'package:media_kit_video/src/video_controller/platform_video_controller.dart';
@@ -25,4 +26,31 @@ class NativeVideoController extends PlatformVideoController {
 
   @override
   Future<void> setSize({int? width, int? height}) => throw UnimplementedError();
+
+  Future<Map<String, dynamic>> getStatistics() => throw UnimplementedError();
+
+  Future<Map<String, dynamic>> getFrameLatency() => throw UnimplementedError();
+
+  Future<int?> createMirror() => throw UnimplementedError();
+
+  Future<void> disposeMirror(int id) => throw UnimplementedError();
+
+  static Future<void> setMemoryLimit(int? limit, {bool downsize = false}) =>
+      throw UnimplementedError();
+
+  static Future<void> setPoolSize(int size) => throw UnimplementedError();
+
+  static Future<Map<String, dynamic>> getMemoryStatistics() =>
+      throw UnimplementedError();
+
+  static Future<int?> createMosaic(int width, int height) =>
+      throw UnimplementedError();
+
+  static Future<void> setMosaicLayout(int id, Map<Player, Rect> tiles) =>
+      throw UnimplementedError();
+
+  static Future<Map<String, dynamic>> getMosaicStatistics(int id) =>
+      throw UnimplementedError();
+
+  static Future<void> disposeMosaic(int id) => throw UnimplementedError();
 }
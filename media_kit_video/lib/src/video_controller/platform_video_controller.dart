@@ -34,6 +34,20 @@ abstract class PlatformVideoController {
   /// [Rect] of the video output, received from the native implementation.
   final ValueNotifier<Rect?> rect = ValueNotifier<Rect?>(null);
 
+  /// [Size] of the texture containing the video output, received from the native implementation.
+  ///
+  /// The texture may be larger than [rect] (the video output is placed at its top-left) to avoid reallocations upon resize.
+  /// `null` if the texture is of the same size as [rect].
+  final ValueNotifier<Size?> textureSize = ValueNotifier<Size?>(null);
+
+  /// Current dynamic resolution scale factor of the video output i.e. [rect] relative to the non-scaled video output.
+  /// `1.0` unless [VideoControllerConfiguration.renderBudget] is exceeded.
+  final ValueNotifier<double> renderScale = ValueNotifier<double>(1.0);
+
+  /// Region of the video contained in the video output (normalized i.e. `0.0` to `1.0` of the video's width & height), received from the native implementation.
+  /// `null` if the video output contains the whole video. See [setCrop].
+  final ValueNotifier<Rect?> crop = ValueNotifier<Rect?>(null);
+
   /// {@macro platform_video_controller}
   PlatformVideoController(
     this.player,
@@ -51,6 +65,21 @@ abstract class PlatformVideoController {
     int? height,
   });
 
+  /// Sets the size (in physical pixels) at which the video output is displayed in [view] (e.g. a [Video]).
+  /// This is invoked by [Video] & only has an effect if [VideoControllerConfiguration.autoSize] is `true` or [VideoControllerConfiguration.enableHardwareAcceleration] is `false`. The video output is rendered at the size required by the largest of the views.
+  /// Pass `null` as [size] once [view] is disposed.
+  Future<void> setDisplaySize(Object view, Size? size) async {}
+
+  /// Sets whether [view] (e.g. a [Video]) displaying the video output is currently visible i.e. not scrolled out of view, offstage or covered.
+  /// This is invoked by [Video]. The video output is considered visible if any of its views is visible; new video frames are not rendered otherwise.
+  /// Pass `null` as [visible] once [view] is disposed.
+  Future<void> setVisible(Object view, bool? visible) async {}
+
+  /// Sets the region of the video (normalized i.e. `0.0` to `1.0` of the video's width & height) visible in [view] (e.g. a [Video]) e.g. not clipped by [BoxFit.cover].
+  /// This is invoked by [Video] & only has an effect if [VideoControllerConfiguration.autoSize] is `true`. Only the region visible in any of the views is rendered.
+  /// Pass `null` as [crop] once [view] is disposed.
+  Future<void> setCrop(Object view, Rect? crop) async {}
+
   /// A [Future] that completes when the first video frame has been rendered.
   Future<void> get waitUntilFirstFrameRendered =>
       waitUntilFirstFrameRenderedCompleter.future;
@@ -63,9 +92,24 @@ abstract class PlatformVideoController {
   void dispose() {
     id.dispose();
     rect.dispose();
+    textureSize.dispose();
+    renderScale.dispose();
+    crop.dispose();
   }
 }
 
+/// Format of the render target into which the video output is rendered.
+enum VideoRenderFormat {
+  /// 8 bits per channel. 4 bytes per pixel.
+  rgba8,
+
+  /// 10 bits per color channel & 2 bit alpha. 4 bytes per pixel.
+  rgb10a2,
+
+  /// 16-bit floating point per channel. 8 bytes per pixel.
+  rgba16f,
+}
+
 /// {@template video_controller_configuration}
 ///
 /// VideoControllerConfiguration
@@ -106,6 +150,81 @@ class VideoControllerConfiguration {
   /// Default: `null`
   final int? height;
 
+  /// Whether to render the video output at the size at which it is displayed by [Video] (multiplied by device pixel ratio), instead of the video's resolution.
+  /// The aspect ratio is maintained & the video output is never rendered larger than the video's resolution.
+  /// This may yield substantial performance improvements when a large video is displayed in a small [Video] e.g. grid layouts.
+  /// If the video is partially clipped by [Video] (e.g. [BoxFit.cover]), only the visible region is rendered. The player's own `video-zoom`, `video-pan-x` & `video-pan-y` are combined with the crop & restored once it is removed.
+  ///
+  /// Only applicable if [width] & [height] are `null`. Currently only supported on GNU/Linux.
+  ///
+  /// Default: `false`
+  final bool autoSize;
+
+  /// Whether to render the video output on a render thread & EGL context shared with all other video outputs created with this option.
+  /// Video outputs with new frames are then rendered back-to-back in a single pass, instead of each one using its own thread & EGL context.
+  /// This may yield substantial performance improvements when many videos are displayed simultaneously e.g. grid layouts.
+  ///
+  /// Only applicable if [enableHardwareAcceleration] is `true`. Currently only supported on GNU/Linux.
+  ///
+  /// Default: `false`
+  final bool sharedRenderContext;
+
+  /// The target time budget for rendering a single video frame.
+  /// If rendering consistently takes longer, the video output is rendered at a lower resolution & it is stepped back up once there is enough headroom.
+  /// The current scale factor is available through [PlatformVideoController.renderScale].
+  ///
+  /// Only applicable if [enableHardwareAcceleration] is `true`. Currently only supported on GNU/Linux.
+  ///
+  /// Default: `null` i.e. disabled.
+  final Duration? renderBudget;
+
+  /// The format of the render target into which the video output is rendered.
+  /// Higher bit depth formats avoid quantizing 10-bit & HDR sources to 8 bits, at the cost of memory & bandwidth.
+  /// If the requested format is not supported by the driver, the next lower one is used.
+  ///
+  /// Only applicable if [enableHardwareAcceleration] is `true`. Currently only supported on GNU/Linux.
+  ///
+  /// Default: [VideoRenderFormat.rgba8]
+  final VideoRenderFormat renderFormat;
+
+  /// Whether to pace video frames using the target presentation times reported by mpv.
+  /// New frames are rendered shortly before they are due (instead of right away) & presentations are reported back to mpv, yielding smoother playback with fewer dropped or repeated frames.
+  ///
+  /// Only applicable if [enableHardwareAcceleration] is `true`. Currently only supported on GNU/Linux.
+  ///
+  /// Default: `false`
+  final bool framePacing;
+
+  /// Whether to record timestamps of each video frame at every stage of the native pipeline (mpv's update, render, flush, texture marked available & taken by Flutter).
+  /// Percentiles of the time spent in each stage over recent frames are available through `NativeVideoController.getFrameLatency`.
+  ///
+  /// Currently only supported on GNU/Linux.
+  ///
+  /// Default: `false`
+  final bool measureFrameLatency;
+
+  /// The maximum width for the video output when rendered in software i.e. [enableHardwareAcceleration] is `false`.
+  /// The video output is scaled down (maintaining aspect ratio) to fit within [softwareMaxWidth] x [softwareMaxHeight]. Software rendering is also sized to the size at which [Video] displays it (multiplied by device pixel ratio), so CPU usage scales with the pixels actually shown.
+  ///
+  /// Only applicable if both [softwareMaxWidth] & [softwareMaxHeight] are set. Currently only supported on GNU/Linux.
+  ///
+  /// Default: `null` i.e. `1920`.
+  final int? softwareMaxWidth;
+
+  /// The maximum height for the video output when rendered in software. See [softwareMaxWidth].
+  ///
+  /// Default: `null` i.e. `1080`.
+  final int? softwareMaxHeight;
+
+  /// The maximum rate (in frames per second) at which the video output renders new frames e.g. `5.0` for background monitoring walls.
+  /// Of the video's frames, the one due nearest to each tick is rendered & marked available to Flutter; the others are skipped. Decoding & audio/video synchronization are not affected.
+  /// The achieved frame rate is available through `NativeVideoController.getStatistics`.
+  ///
+  /// Currently only supported on GNU/Linux.
+  ///
+  /// Default: `null` i.e. unlimited.
+  final double? maxFps;
+
   /// Whether to enable hardware acceleration.
   ///
   /// DO NOT DISABLE THIS OPTION MEANINGLESSLY.
@@ -128,6 +247,15 @@ class VideoControllerConfiguration {
     this.width,
     this.height,
     this.scale = 1.0,
+    this.autoSize = false,
+    this.sharedRenderContext = false,
+    this.renderBudget,
+    this.renderFormat = VideoRenderFormat.rgba8,
+    this.framePacing = false,
+    this.measureFrameLatency = false,
+    this.softwareMaxWidth,
+    this.softwareMaxHeight,
+    this.maxFps,
     this.enableHardwareAcceleration = true,
     this.androidAttachSurfaceAfterVideoParameters,
   });
@@ -139,6 +267,15 @@ class VideoControllerConfiguration {
     double? scale,
     int? width,
     int? height,
+    bool? autoSize,
+    bool? sharedRenderContext,
+    Duration? renderBudget,
+    VideoRenderFormat? renderFormat,
+    bool? framePacing,
+    bool? measureFrameLatency,
+    int? softwareMaxWidth,
+    int? softwareMaxHeight,
+    double? maxFps,
     bool? enableHardwareAcceleration,
     bool? androidAttachSurfaceAfterVideoParameters,
   }) =>
@@ -148,6 +285,15 @@ class VideoControllerConfiguration {
         scale: scale ?? this.scale,
         width: width ?? this.width,
         height: height ?? this.height,
+        autoSize: autoSize ?? this.autoSize,
+        sharedRenderContext: sharedRenderContext ?? this.sharedRenderContext,
+        renderBudget: renderBudget ?? this.renderBudget,
+        renderFormat: renderFormat ?? this.renderFormat,
+        framePacing: framePacing ?? this.framePacing,
+        measureFrameLatency: measureFrameLatency ?? this.measureFrameLatency,
+        softwareMaxWidth: softwareMaxWidth ?? this.softwareMaxWidth,
+        softwareMaxHeight: softwareMaxHeight ?? this.softwareMaxHeight,
+        maxFps: maxFps ?? this.maxFps,
         enableHardwareAcceleration:
             enableHardwareAcceleration ?? this.enableHardwareAcceleration,
         androidAttachSurfaceAfterVideoParameters:
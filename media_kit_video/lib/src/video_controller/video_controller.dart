@@ -39,12 +39,28 @@ import 'package:media_kit_video/src/video_controller/web_video_controller/web_vi
 /// 3. You can switch between GPU & CPU rendering by specifying [VideoControllerConfiguration.enableHardwareAcceleration].
 ///    * Disabling the option may improve stability on certain devices.
 ///    * By default, [VideoControllerConfiguration.enableHardwareAcceleration] is `true` i.e. GPU (Direct3D/OpenGL/METAL) is utilized.
+/// 4. You can render the video output at the size at which [Video] displays it by specifying [VideoControllerConfiguration.autoSize].
+///    * This may yield substantial performance improvements when a large video is displayed in a small [Video].
+///    * By default, [VideoControllerConfiguration.autoSize] is `false` i.e. output is based on video's resolution.
+/// 5. You can render multiple video outputs on a single shared render thread & context by specifying [VideoControllerConfiguration.sharedRenderContext].
+///    * This may yield substantial performance improvements when many [Video]s are displayed simultaneously.
+///    * By default, [VideoControllerConfiguration.sharedRenderContext] is `false` i.e. each video output has its own render thread & context.
 ///
 /// **Platform specific limitations & differences:**
 ///
 /// **Android**
 /// * [VideoControllerConfiguration.width] & [VideoControllerConfiguration.height] arguments have no effect.
 ///
+/// **Windows, macOS & iOS**
+/// * [VideoControllerConfiguration.autoSize] argument has no effect.
+/// * [VideoControllerConfiguration.sharedRenderContext] argument has no effect.
+/// * [VideoControllerConfiguration.renderBudget] argument has no effect.
+/// * [VideoControllerConfiguration.renderFormat] argument has no effect.
+/// * [VideoControllerConfiguration.framePacing] argument has no effect.
+/// * [VideoControllerConfiguration.measureFrameLatency] argument has no effect.
+/// * [VideoControllerConfiguration.softwareMaxWidth] & [VideoControllerConfiguration.softwareMaxHeight] arguments have no effect.
+/// * [VideoControllerConfiguration.maxFps] argument has no effect.
+///
 /// **Web**
 /// * [VideoControllerConfiguration.width] & [VideoControllerConfiguration.height] arguments have no effect.
 /// * Only single [Video] output can be displayed for a [VideoController].
@@ -0,0 +1,169 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#include "include/media_kit_video/frame_latency.h"
+
+#include <algorithm>
+#include <atomic>
+
+typedef struct _FrameLatencyEntry {
+  std::atomic<guint64> frame; /* ID of the frame, 0 while (re)written. */
+  std::atomic<gint64> stamps[FRAME_LATENCY_STAGE_COUNT]; /* 0 if not yet. */
+} FrameLatencyEntry;
+
+struct _FrameLatency {
+  std::atomic<gint64> update;   /* Last update callback not yet rendered. */
+  std::atomic<guint64> current; /* ID of the current frame. */
+  FrameLatencyEntry entries[FRAME_LATENCY_FRAME_COUNT];
+};
+
+// Name of the time spent until reaching each stage (from the previous one).
+static const gchar* kFrameLatencyStageNames[FRAME_LATENCY_STAGE_COUNT] = {
+    NULL, "queue", "render", "flush", "mark", "present",
+};
+
+FrameLatency* frame_latency_new() {
+  // Value-initialized i.e. all IDs & timestamps are 0.
+  return new FrameLatency();
+}
+
+void frame_latency_free(FrameLatency* self) {
+  delete self;
+}
+
+void frame_latency_update(FrameLatency* self) {
+  if (self == NULL) {
+    return;
+  }
+  // First one wins i.e. until |frame_latency_begin| takes (& resets) it, so
+  // that further update callbacks before the render do not hide queueing.
+  gint64 expected = 0;
+  self->update.compare_exchange_strong(expected, g_get_monotonic_time(),
+                                       std::memory_order_relaxed);
+}
+
+guint64 frame_latency_begin(FrameLatency* self) {
+  if (self == NULL) {
+    return 0;
+  }
+  guint64 frame = self->current.load(std::memory_order_relaxed) + 1;
+  FrameLatencyEntry* entry = &self->entries[frame % FRAME_LATENCY_FRAME_COUNT];
+  // Readers skip the entry while it is being overwritten.
+  entry->frame.store(0, std::memory_order_release);
+  for (gint i = 0; i < FRAME_LATENCY_STAGE_COUNT; i++) {
+    entry->stamps[i].store(0, std::memory_order_relaxed);
+  }
+  entry->stamps[FRAME_LATENCY_STAGE_UPDATE].store(
+      self->update.exchange(0, std::memory_order_relaxed),
+      std::memory_order_relaxed);
+  entry->stamps[FRAME_LATENCY_STAGE_RENDER].store(g_get_monotonic_time(),
+                                                  std::memory_order_relaxed);
+  entry->frame.store(frame, std::memory_order_release);
+  self->current.store(frame, std::memory_order_release);
+  return frame;
+}
+
+guint64 frame_latency_get_current(FrameLatency* self) {
+  if (self == NULL) {
+    return 0;
+  }
+  return self->current.load(std::memory_order_acquire);
+}
+
+void frame_latency_record(FrameLatency* self, FrameLatencyStage stage) {
+  frame_latency_record_frame(self, frame_latency_get_current(self), stage);
+}
+
+void frame_latency_record_frame(FrameLatency* self,
+                                guint64 frame,
+                                FrameLatencyStage stage) {
+  if (self == NULL || frame == 0) {
+    return;
+  }
+  FrameLatencyEntry* entry = &self->entries[frame % FRAME_LATENCY_FRAME_COUNT];
+  if (entry->frame.load(std::memory_order_acquire) != frame) {
+    return;
+  }
+  // First one wins e.g. re-renders of the same frame after a resize.
+  gint64 expected = 0;
+  entry->stamps[stage].compare_exchange_strong(expected, g_get_monotonic_time(),
+                                               std::memory_order_relaxed);
+}
+
+static FlValue* frame_latency_percentiles(gint64* samples, guint count) {
+  std::sort(samples, samples + count);
+  FlValue* percentiles = fl_value_new_map();
+  const gint ranks[] = {50, 95, 99};
+  const gchar* names[] = {"p50", "p95", "p99"};
+  for (gint i = 0; i < 3; i++) {
+    // Nearest-rank.
+    guint index = (count * ranks[i] + 99) / 100 - 1;
+    fl_value_set_string_take(percentiles, names[i],
+                             fl_value_new_int(samples[index]));
+  }
+  fl_value_set_string_take(percentiles, "samples", fl_value_new_int(count));
+  return percentiles;
+}
+
+FlValue* frame_latency_get_statistics(FrameLatency* self) {
+  FlValue* statistics = fl_value_new_map();
+  if (self == NULL) {
+    return statistics;
+  }
+  // Last row holds the total i.e. update callback to Flutter taking the frame.
+  gint64 samples[FRAME_LATENCY_STAGE_COUNT + 1][FRAME_LATENCY_FRAME_COUNT];
+  guint counts[FRAME_LATENCY_STAGE_COUNT + 1] = {0};
+  guint frames = 0;
+  for (gint i = 0; i < FRAME_LATENCY_FRAME_COUNT; i++) {
+    FrameLatencyEntry* entry = &self->entries[i];
+    guint64 frame = entry->frame.load(std::memory_order_acquire);
+    if (frame == 0) {
+      continue;
+    }
+    gint64 stamps[FRAME_LATENCY_STAGE_COUNT];
+    for (gint j = 0; j < FRAME_LATENCY_STAGE_COUNT; j++) {
+      stamps[j] = entry->stamps[j].load(std::memory_order_relaxed);
+    }
+    // Overwritten in the meantime.
+    if (entry->frame.load(std::memory_order_acquire) != frame) {
+      continue;
+    }
+    frames++;
+    // Stages which were not recorded (e.g. flush with S/W rendering) are
+    // attributed to the next recorded one.
+    gint64 previous = stamps[FRAME_LATENCY_STAGE_UPDATE];
+    for (gint j = FRAME_LATENCY_STAGE_RENDER; j < FRAME_LATENCY_STAGE_COUNT;
+         j++) {
+      if (stamps[j] == 0) {
+        continue;
+      }
+      if (previous > 0 && stamps[j] >= previous) {
+        samples[j][counts[j]++] = stamps[j] - previous;
+      }
+      previous = stamps[j];
+    }
+    gint64 update = stamps[FRAME_LATENCY_STAGE_UPDATE];
+    gint64 populated = stamps[FRAME_LATENCY_STAGE_POPULATED];
+    if (update > 0 && populated >= update) {
+      guint* count = &counts[FRAME_LATENCY_STAGE_COUNT];
+      samples[FRAME_LATENCY_STAGE_COUNT][(*count)++] = populated - update;
+    }
+  }
+  fl_value_set_string_take(statistics, "frames", fl_value_new_int(frames));
+  for (gint i = FRAME_LATENCY_STAGE_RENDER; i <= FRAME_LATENCY_STAGE_COUNT;
+       i++) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    const gchar* name =
+        i == FRAME_LATENCY_STAGE_COUNT ? "total" : kFrameLatencyStageNames[i];
+    fl_value_set_string_take(statistics, name,
+                             frame_latency_percentiles(samples[i], counts[i]));
+  }
+  return statistics;
+}
@@ -0,0 +1,77 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#ifndef FRAME_LATENCY_H_
+#define FRAME_LATENCY_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+// Number of most recent frames kept in a |FrameLatency| ring.
+#define FRAME_LATENCY_FRAME_COUNT 256
+
+// Stages of the video pipeline a frame passes through, in order.
+typedef enum _FrameLatencyStage {
+  FRAME_LATENCY_STAGE_UPDATE,    /* mpv's update callback. */
+  FRAME_LATENCY_STAGE_RENDER,    /* Render started. */
+  FRAME_LATENCY_STAGE_RENDERED,  /* |mpv_render_context_render| returned. */
+  FRAME_LATENCY_STAGE_FLUSHED,   /* OpenGL commands flushed (H/W only). */
+  FRAME_LATENCY_STAGE_MARKED,    /* Texture marked as frame available. */
+  FRAME_LATENCY_STAGE_POPULATED, /* Frame taken by Flutter's raster thread. */
+  FRAME_LATENCY_STAGE_COUNT,
+} FrameLatencyStage;
+
+// Per-video output ring of monotonic timestamps at each |FrameLatencyStage| of
+// the most recent frames. Lock-free: stages are recorded from mpv's, the
+// render & Flutter's raster thread without blocking each other. All functions
+// accept NULL (i.e. instrumentation disabled) & do nothing in that case.
+typedef struct _FrameLatency FrameLatency;
+
+FrameLatency* frame_latency_new();
+
+void frame_latency_free(FrameLatency* self);
+
+/**
+ * @brief Records |FRAME_LATENCY_STAGE_UPDATE| for the next frame, unless
+ * already recorded. May be called from any thread.
+ */
+void frame_latency_update(FrameLatency* self);
+
+/**
+ * @brief Starts a new (current) frame & records |FRAME_LATENCY_STAGE_RENDER|.
+ * Must be called from the thread rendering the frames.
+ *
+ * @return ID of the frame.
+ */
+guint64 frame_latency_begin(FrameLatency* self);
+
+/**
+ * @brief Returns ID of the current frame i.e. last one started with
+ * |frame_latency_begin| or 0.
+ */
+guint64 frame_latency_get_current(FrameLatency* self);
+
+/**
+ * @brief Records |stage| for the current frame.
+ */
+void frame_latency_record(FrameLatency* self, FrameLatencyStage stage);
+
+/**
+ * @brief Records |stage| for frame with ID |frame|, unless already recorded or
+ * the frame is no longer in the ring.
+ */
+void frame_latency_record_frame(FrameLatency* self,
+                                guint64 frame,
+                                FrameLatencyStage stage);
+
+/**
+ * @brief Returns 50th, 95th & 99th percentiles (microseconds) of the time
+ * spent in each stage over the frames in the ring, as a new |FlValue| map.
+ */
+FlValue* frame_latency_get_statistics(FrameLatency* self);
+
+#endif  // FRAME_LATENCY_H_
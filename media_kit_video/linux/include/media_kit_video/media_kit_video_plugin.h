@@ -29,6 +29,111 @@ FLUTTER_PLUGIN_EXPORT GType media_kit_video_plugin_get_type();
 FLUTTER_PLUGIN_EXPORT void media_kit_video_plugin_register_with_registrar(
     FlPluginRegistrar* registrar);
 
+// Rendered video frame exported as a (single plane) dma-buf. The video frame
+// is placed at the top-left of the buffer.
+typedef struct _MediaKitVideoDmaBufFrame {
+  gint fd;           // Owned by media_kit_video; dup(2) it to keep the buffer.
+  gint32 width;      // Dimensions of the video frame.
+  gint32 height;
+  gint32 stride;     // Bytes per row of the buffer.
+  gint32 offset;     // Offset of the first pixel within the buffer.
+  guint32 fourcc;    // DRM_FORMAT_* code.
+  guint64 modifier;  // DRM_FORMAT_MOD_* code.
+  gdouble pts;       // Presentation timestamp in seconds or -1 if unknown.
+  guint64 id;        // See |media_kit_video_plugin_release_dma_buf_frame|.
+  gint fence_fd;     // Sync file signaled once rendering has completed or -1
+                     // if it already has. Owned by the consumer (close(2) it).
+} MediaKitVideoDmaBufFrame;
+
+// Invoked on the render thread for rendered video frames, right after their
+// rendering was submitted to the GPU: The buffer must only be read once
+// |fence_fd| has signaled (e.g. poll(2) it for POLLIN). |frame| is only valid
+// for the duration of the call. The frame is held by the consumer until
+// released through |media_kit_video_plugin_release_dma_buf_frame|: Its buffer
+// is not rendered into meanwhile & newer frames are not delivered.
+typedef void (*MediaKitVideoDmaBufFrameCallback)(
+    const MediaKitVideoDmaBufFrame* frame,
+    gpointer context);
+
+typedef enum _MediaKitVideoDmaBufExportResult {
+  MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_OK,
+  // No video output exists for the handle.
+  MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_NOT_FOUND,
+  // S/W rendering is used or the driver lacks EGL_MESA_image_dma_buf_export.
+  MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_NOT_SUPPORTED,
+} MediaKitVideoDmaBufExportResult;
+
+/**
+ * @brief Sets the callback receiving rendered video frames of the video output
+ * created for |handle| (|mpv_handle| casted to gint64) as dma-bufs. Pass NULL
+ * |callback| to stop. Must be called on the platform thread. The previous
+ * callback is not invoked again once this returns (i.e. its |context| may be
+ * freed).
+ */
+FLUTTER_PLUGIN_EXPORT MediaKitVideoDmaBufExportResult
+media_kit_video_plugin_set_dma_buf_frame_callback(
+    gint64 handle,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context);
+
+/**
+ * @brief Releases the dma-buf frame with |id| delivered for the video output
+ * created for |handle|, once the consumer is done reading its buffer. Must be
+ * called on the platform thread. Clearing the callback also releases the held
+ * frame.
+ */
+FLUTTER_PLUGIN_EXPORT void media_kit_video_plugin_release_dma_buf_frame(
+    gint64 handle,
+    guint64 id);
+
+// Rendered video frame read back to CPU memory (RGBA, 8 bits per channel, top
+// row first).
+typedef struct _MediaKitVideoFrameTapFrame {
+  const guint8* data;  // Only valid for the duration of the callback.
+  gint32 width;
+  gint32 height;
+  gint32 stride;       // Bytes per row.
+  gdouble pts;         // Presentation timestamp in seconds or -1 if unknown.
+} MediaKitVideoFrameTapFrame;
+
+// Invoked on the render thread, one or more frames after the frame was
+// rendered (the read back happens asynchronously).
+typedef void (*MediaKitVideoFrameTapCallback)(
+    const MediaKitVideoFrameTapFrame* frame,
+    gpointer context);
+
+typedef struct _MediaKitVideoFrameTapConfiguration {
+  // Frames are downscaled (maintaining aspect ratio) to fit these dimensions.
+  // 0 for no limit.
+  gint32 max_width;
+  gint32 max_height;
+  // Maximum number of frames read back per second. 0 for no limit.
+  gdouble max_fps;
+} MediaKitVideoFrameTapConfiguration;
+
+typedef enum _MediaKitVideoFrameTapResult {
+  MEDIA_KIT_VIDEO_FRAME_TAP_OK,
+  // No video output exists for the handle.
+  MEDIA_KIT_VIDEO_FRAME_TAP_NOT_FOUND,
+  // S/W rendering or the RGBA16F render format is used.
+  MEDIA_KIT_VIDEO_FRAME_TAP_NOT_SUPPORTED,
+} MediaKitVideoFrameTapResult;
+
+/**
+ * @brief Sets the callback receiving rendered video frames of the video output
+ * created for |handle| (|mpv_handle| casted to gint64) in CPU memory. Frames
+ * are read back asynchronously through a ring of pixel buffer objects, so the
+ * render thread never waits for the GPU. Pass NULL |callback| to stop. Must be
+ * called on the platform thread. The previous callback is not invoked again
+ * once this returns (i.e. its |context| may be freed).
+ */
+FLUTTER_PLUGIN_EXPORT MediaKitVideoFrameTapResult
+media_kit_video_plugin_set_frame_tap_callback(
+    gint64 handle,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context);
+
 G_END_DECLS
 
 #endif  // FLUTTER_PLUGIN_MEDIA_KIT_VIDEO_PLUGIN_H_
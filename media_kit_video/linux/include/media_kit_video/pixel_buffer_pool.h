@@ -0,0 +1,52 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#ifndef PIXEL_BUFFER_POOL_H_
+#define PIXEL_BUFFER_POOL_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+// Smallest capacity handed out i.e. a 128x128 RGBA frame.
+#define PIXEL_BUFFER_POOL_MIN_CAPACITY (64 * 1024)
+// Capacities from this size onwards are multiples of (& aligned to) the
+// transparent hugepage size.
+#define PIXEL_BUFFER_POOL_HUGEPAGE_SIZE (2 * 1024 * 1024)
+// Bytes kept in the pool for reuse. Released buffers beyond are freed.
+#define PIXEL_BUFFER_POOL_MAX_MEMORY (32 * 1024 * 1024)
+
+// Process-wide pool of S/W rendering pixel buffers, recycled across
+// |VideoOutput|s as they are created & disposed. Capacities are rounded up in
+// coarse steps (powers of two below |PIXEL_BUFFER_POOL_HUGEPAGE_SIZE|,
+// multiples of it above), so that buffers of similarly sized outputs are
+// interchangeable. Thread-safe.
+
+/**
+ * @brief Returns the capacity of a buffer holding at least |size| bytes.
+ */
+gsize pixel_buffer_pool_get_capacity(gsize size);
+
+/**
+ * @brief Returns a buffer of |pixel_buffer_pool_get_capacity(size)| bytes,
+ * reused from the pool if possible. Contents are undefined.
+ */
+guint8* pixel_buffer_pool_acquire(gsize size);
+
+/**
+ * @brief Returns |data| of |capacity| bytes (from |pixel_buffer_pool_acquire|)
+ * to the pool. NULL is ignored.
+ */
+void pixel_buffer_pool_release(guint8* data, gsize capacity);
+
+/**
+ * @brief Returns memory held by the pool (i.e. not in use), number of pooled
+ * buffers & how many acquisitions were served from the pool, as a new
+ * |FlValue| map.
+ */
+FlValue* pixel_buffer_pool_get_statistics();
+
+#endif  // PIXEL_BUFFER_POOL_H_
@@ -0,0 +1,99 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#ifndef RENDER_THREAD_H_
+#define RENDER_THREAD_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <epoxy/egl.h>
+
+// Callback invoked on the render thread.
+typedef void (*RenderThreadCallback)(gpointer data);
+
+#define RENDER_THREAD_TYPE (render_thread_get_type())
+
+// Dedicated thread owning an isolated (non-shared) EGL context, or none for
+// S/W rendering. All mpv rendering happens here, off Flutter's raster thread &
+// the GTK main thread.
+G_DECLARE_FINAL_TYPE(RenderThread,
+                     render_thread,
+                     RENDER_THREAD,
+                     RENDER_THREAD,
+                     GObject)
+
+#define RENDER_THREAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj), render_thread_get_type(), RenderThread))
+
+/**
+ * @brief Creates a new |RenderThread| instance. The isolated EGL context is
+ * created from |egl_config| & made current on the render thread for its entire
+ * lifetime.
+ *
+ * @param egl_display EGL display (shared with Flutter).
+ * @param egl_config EGL config used to create the isolated EGL context.
+ * @return RenderThread*
+ */
+RenderThread* render_thread_new(EGLDisplay egl_display, EGLConfig egl_config);
+
+/**
+ * @brief Creates a new |RenderThread| instance without an EGL context, which
+ * only processes requests & invocations e.g. for S/W rendering.
+ */
+RenderThread* render_thread_new_sw();
+
+EGLDisplay render_thread_get_egl_display(RenderThread* self);
+
+/**
+ * @brief Returns the isolated EGL context or |EGL_NO_CONTEXT| if it could not
+ * be created.
+ */
+EGLContext render_thread_get_egl_context(RenderThread* self);
+
+/**
+ * @brief Invokes |callback| on the render thread & blocks until it returns.
+ * May be called from the render thread itself.
+ */
+void render_thread_invoke(RenderThread* self,
+                          RenderThreadCallback callback,
+                          gpointer data);
+
+/**
+ * @brief Requests |callback| to be invoked on the render thread. Requests are
+ * coalesced by |data| i.e. multiple requests made before the render thread
+ * gets to them result in a single invocation.
+ */
+void render_thread_request_render(RenderThread* self,
+                                  RenderThreadCallback callback,
+                                  gpointer data);
+
+/**
+ * @brief Same as |render_thread_request_render|, but the request is not due
+ * before monotonic time |time| (see |g_get_monotonic_time|). A pending request
+ * for |data| is due at the earlier of both times.
+ */
+void render_thread_request_render_at(RenderThread* self,
+                                     RenderThreadCallback callback,
+                                     gpointer data,
+                                     gint64 time);
+
+/**
+ * @brief Drops pending render requests for |data|. Must be called on the
+ * render thread (i.e. from inside |render_thread_invoke|) to guarantee that no
+ * further invocation for |data| is in-flight.
+ */
+void render_thread_cancel(RenderThread* self, gpointer data);
+
+/**
+ * @brief Adds render thread statistics to |statistics| map: number of context
+ * switches (|eglMakeCurrent| calls) made on the thread, number of passes (i.e.
+ * batches of render requests processed back-to-back) & time spent per pass in
+ * microseconds.
+ */
+void render_thread_get_statistics(RenderThread* self, FlValue* statistics);
+
+#endif  // RENDER_THREAD_H_
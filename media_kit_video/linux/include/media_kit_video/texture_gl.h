@@ -23,7 +23,121 @@ G_DECLARE_FINAL_TYPE(TextureGL, texture_gl, TEXTURE_GL, TEXTURE_GL, FlTextureGL)
 TextureGL* texture_gl_new(VideoOutput* video_output);
 
 /**
- * @brief Populates texture with video frame.
+ * @brief Creates a new |TextureGL| for |egl_display| which is not yet rendered
+ * into by any |VideoOutput| e.g. to register it with Flutter ahead of time. Set
+ * the |VideoOutput| with |texture_gl_set_video_output| before use.
+ */
+TextureGL* texture_gl_new_pooled(EGLDisplay egl_display);
+
+/**
+ * @brief Sets the |VideoOutput| rendering into a |TextureGL| created with
+ * |texture_gl_new_pooled|.
+ */
+void texture_gl_set_video_output(TextureGL* self, VideoOutput* video_output);
+
+/**
+ * @brief Creates a new |TextureGL| sampling the frames rendered by |source|
+ * i.e. without any additional rendering. Returns NULL if |source| already has
+ * the maximum number of mirrors.
+ */
+TextureGL* texture_gl_new_mirror(TextureGL* source);
+
+/**
+ * @brief Returns the (approximate) GPU memory in bytes required by the render
+ * targets of a |width| x |height| video output in |format|.
+ */
+guint64 texture_gl_estimate_memory(VideoOutputFormat format,
+                                   gint64 width,
+                                   gint64 height);
+
+/**
+ * @brief Marks a new frame available for |self| & its mirrors.
+ */
+void texture_gl_mark_frame_available(TextureGL* self,
+                                     FlTextureRegistrar* texture_registrar);
+
+/**
+ * @brief Renders the current video frame into a free slot of the FBO/EGLImage
+ * ring. Must be called on the render thread.
+ *
+ * @param frame Whether mpv reported a new video frame. If not, the render is
+ * skipped unless the required dimensions changed since the last render.
+ * @param target_time mpv's target time of the frame (with frame pacing, the
+ * render does not block until it) or 0 if unknown.
+ * @return Whether a new frame is available for Flutter.
+ */
+gboolean texture_gl_render(TextureGL* self,
+                           gboolean frame,
+                           gint64 target_time);
+
+/**
+ * @brief Whether rendered frames are consumed other than through this texture
+ * i.e. by mirrors, a dma-buf frame callback or a frame tap.
+ */
+gboolean texture_gl_has_consumers(TextureGL* self);
+
+/**
+ * @brief Retrieves the FBO, dimensions & serial (render count) of the newest
+ * rendered frame. Must be called on the render thread.
+ *
+ * @return FALSE if no frame was rendered yet.
+ */
+gboolean texture_gl_get_frame(TextureGL* self,
+                              guint32* fbo,
+                              guint32* width,
+                              guint32* height,
+                              guint64* serial);
+
+/**
+ * @brief Releases mpv's OpenGL resources i.e. FBOs, textures & EGLImages of
+ * the ring. Must be called on the render thread.
+ */
+void texture_gl_release(TextureGL* self);
+
+/**
+ * @brief Adds render statistics (e.g. performed & skipped render counts) to
+ * |statistics| map.
+ */
+void texture_gl_get_statistics(TextureGL* self, FlValue* statistics);
+
+/**
+ * @brief Sets the callback receiving rendered frames as dma-bufs (through
+ * EGL_MESA_image_dma_buf_export). Pass NULL |callback| to stop, which also
+ * releases the held frame. Blocks until a delivery in-flight on the render
+ * thread has returned, i.e. the previous callback is not invoked again once
+ * this returns.
+ *
+ * @return Whether the driver supports dma-buf export.
+ */
+gboolean texture_gl_set_dma_buf_frame_callback(
+    TextureGL* self,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context);
+
+/**
+ * @brief Releases the dma-buf frame with |id| held by the consumer, its slot
+ * may then be rendered into again. Thread-safe.
+ *
+ * @return FALSE if the frame is not held (e.g. already released).
+ */
+gboolean texture_gl_release_dma_buf_frame(TextureGL* self, guint64 id);
+
+/**
+ * @brief Sets the callback receiving rendered frames read back to CPU memory
+ * through a ring of pixel buffer objects. Pass NULL |callback| to stop.
+ * Blocks until a delivery in-flight on the render thread has returned, i.e.
+ * the previous callback is not invoked again once this returns.
+ *
+ * @return Whether the read back is supported for the render format.
+ */
+gboolean texture_gl_set_frame_tap_callback(
+    TextureGL* self,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context);
+
+/**
+ * @brief Populates texture with the newest finished video frame.
  */
 gboolean texture_gl_populate_texture(FlTextureGL* texture,
                                      guint32* target,
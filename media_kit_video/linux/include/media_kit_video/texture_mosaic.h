@@ -0,0 +1,96 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#ifndef TEXTURE_MOSAIC_H_
+#define TEXTURE_MOSAIC_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include "video_output.h"
+
+// Maximum number of tiles in a |TextureMosaic|.
+#define TEXTURE_MOSAIC_MAX_TILES 64
+
+// Rectangle of a tile within the mosaic (in pixels, origin at top-left).
+typedef struct _TextureMosaicRect {
+  gint32 left;
+  gint32 top;
+  gint32 width;
+  gint32 height;
+} TextureMosaicRect;
+
+#define TEXTURE_MOSAIC_TYPE (texture_mosaic_get_type())
+
+// Single texture composed of the video frames of multiple |VideoOutput|s
+// (tiles), e.g. for video walls. Tiles must be rendered on the same (shared)
+// render thread; their newest frames are copied into the tile rectangles of
+// the mosaic whenever they render a new frame.
+G_DECLARE_FINAL_TYPE(TextureMosaic,
+                     texture_mosaic,
+                     TEXTURE_MOSAIC,
+                     TEXTURE_MOSAIC,
+                     FlTextureGL)
+
+#define TEXTURE_MOSAIC(obj)                                     \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj), texture_mosaic_get_type(), \
+                              TextureMosaic))
+
+/**
+ * @brief Creates a new |width| x |height| |TextureMosaic| without any tiles.
+ */
+TextureMosaic* texture_mosaic_new(FlTextureRegistrar* texture_registrar,
+                                  gint32 width,
+                                  gint32 height);
+
+/**
+ * @brief Replaces the tiles of the mosaic. Tiles which cannot be composed i.e.
+ * not rendered on the mosaic's render thread (the one of its first tile), with
+ * S/W rendering, in RGBA16F or beyond |TEXTURE_MOSAIC_MAX_TILES| are rejected.
+ * A |VideoOutput| may be a tile of a single mosaic at a time.
+ *
+ * @param video_outputs |VideoOutput|s of the tiles.
+ * @param rects Rectangles of the tiles. Video frames are fitted inside,
+ * maintaining aspect ratio.
+ * @param count Number of tiles.
+ * @param rejected Set to TRUE for each rejected tile (|count| entries).
+ * @return Number of rejected tiles.
+ */
+guint texture_mosaic_set_layout(TextureMosaic* self,
+                                VideoOutput** video_outputs,
+                                const TextureMosaicRect* rects,
+                                guint count,
+                                gboolean* rejected);
+
+/**
+ * @brief Removes |video_output| from the tiles (if present). Must be called
+ * before |video_output| is disposed.
+ */
+void texture_mosaic_remove_video_output(TextureMosaic* self,
+                                        VideoOutput* video_output);
+
+/**
+ * @brief Returns the bytes of GPU memory held by the mosaic's textures.
+ */
+guint64 texture_mosaic_get_memory(TextureMosaic* self);
+
+/**
+ * @brief Adds composition statistics to |statistics| map.
+ */
+void texture_mosaic_get_statistics(TextureMosaic* self, FlValue* statistics);
+
+/**
+ * @brief Populates texture with the newest composed frame.
+ */
+gboolean texture_mosaic_populate_texture(FlTextureGL* texture,
+                                         guint32* target,
+                                         guint32* name,
+                                         guint32* width,
+                                         guint32* height,
+                                         GError** error);
+
+#endif  // TEXTURE_MOSAIC_H_
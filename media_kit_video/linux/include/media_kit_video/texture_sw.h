@@ -32,11 +32,12 @@ gboolean texture_sw_copy_pixels(FlPixelBufferTexture* texture,
                                 guint32* height,
                                 GError** error);
 
-// Limit the frame size to 1080p in software rendering.
-// This is for performance reasons & to avoid allocating too much memory.
+// Default limit of the frame size in software rendering (see
+// |VideoOutputConfiguration::sw_max_width|), for performance reasons.
 #define SW_RENDERING_MAX_WIDTH 1920
 #define SW_RENDERING_MAX_HEIGHT 1080
-#define SW_RENDERING_PIXEL_BUFFER_SIZE \
-  (SW_RENDERING_MAX_WIDTH) * (SW_RENDERING_MAX_HEIGHT) * (4)
+// Pixel buffers per video output: being rendered, newest complete & held by
+// Flutter.
+#define SW_RENDERING_PIXEL_BUFFER_COUNT 3
 
 #endif  // TEXTURE_SW_H_
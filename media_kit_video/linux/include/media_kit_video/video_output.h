@@ -16,23 +16,90 @@
 #include "mpv/render.h"
 #include "mpv/render_gl.h"
 
+#include "frame_latency.h"
+#include "media_kit_video_plugin.h"
+#include "render_thread.h"
+
+// Format of the render target (texture) the video output is rendered into.
+// Higher bit depth formats avoid quantizing 10-bit (or HDR) sources to 8 bits.
+typedef enum _VideoOutputFormat {
+  VIDEO_OUTPUT_FORMAT_RGBA8,
+  VIDEO_OUTPUT_FORMAT_RGB10_A2,
+  VIDEO_OUTPUT_FORMAT_RGBA16F,
+} VideoOutputFormat;
+
 typedef struct _VideoOutputConfiguration {
   gint64 width;
   gint64 height;
   bool enable_hardware_acceleration;
+  bool shared_render_thread;
+  gint64 render_budget; /* Microseconds. 0 disables dynamic resolution. */
+  VideoOutputFormat format; /* Requested; falls back if unsupported. */
+  bool frame_pacing; /* Render as per mpv's target time & report swaps. */
+  bool measure_frame_latency; /* Record per-frame pipeline timestamps. */
+  gint64 memory_budget; /* Bytes for render targets. 0 i.e. unlimited. */
+  gint64 sw_max_width;  /* S/W render size cap (aspect ratio maintained). */
+  gint64 sw_max_height; /* 0 i.e. |SW_RENDERING_MAX_WIDTH| x |..._HEIGHT|. */
+  gdouble max_fps; /* Frame rate cap of rendering. 0 i.e. unlimited. */
 
   _VideoOutputConfiguration(gint64 width = NULL,
                             gint64 height = NULL,
-                            bool enable_hardware_acceleration = true)
+                            bool enable_hardware_acceleration = true,
+                            bool shared_render_thread = false,
+                            gint64 render_budget = 0,
+                            VideoOutputFormat format =
+                                VIDEO_OUTPUT_FORMAT_RGBA8,
+                            bool frame_pacing = false,
+                            bool measure_frame_latency = false,
+                            gint64 memory_budget = 0,
+                            gint64 sw_max_width = 0,
+                            gint64 sw_max_height = 0,
+                            gdouble max_fps = 0.0)
       : width(width),
         height(height),
-        enable_hardware_acceleration(enable_hardware_acceleration) {}
+        enable_hardware_acceleration(enable_hardware_acceleration),
+        shared_render_thread(shared_render_thread),
+        render_budget(render_budget),
+        format(format),
+        frame_pacing(frame_pacing),
+        measure_frame_latency(measure_frame_latency),
+        memory_budget(memory_budget),
+        sw_max_width(sw_max_width),
+        sw_max_height(sw_max_height),
+        max_fps(max_fps) {}
 } VideoOutputConfiguration;
 
+// Region of the video rendered into the video output, normalized to the
+// video's (rotated) dimensions i.e. {0.0, 0.0, 1.0, 1.0} if not cropped.
+typedef struct _VideoOutputCrop {
+  gdouble left;
+  gdouble top;
+  gdouble width;
+  gdouble height;
+} VideoOutputCrop;
+
+typedef struct _TextureGL TextureGL;
+
+// Resources of a H/W |VideoOutput| which do not depend on the player, created
+// ahead of time (see |video_output_manager_set_pool_size|) to cut the time
+// taken by |video_output_new|. Adopted members are set to NULL.
+typedef struct _VideoOutputPrewarmed {
+  RenderThread* render_thread; /* Dedicated, its EGL context already current. */
+  TextureGL* texture_gl;       /* Registered with Flutter, not yet rendered. */
+} VideoOutputPrewarmed;
+
 // Callback invoked when the texture ID updates i.e. video dimensions changes.
+// |texture_width| & |texture_height| are dimensions of the underlying texture,
+// which may be larger than the video frame (placed at its top-left). |scale| is
+// the current dynamic resolution scale factor (1.0 if not scaled down). |crop|
+// is the region of the video the frame contains.
 typedef void (*TextureUpdateCallback)(gint64 id,
                                       gint64 width,
                                       gint64 height,
+                                      gint64 texture_width,
+                                      gint64 texture_height,
+                                      gdouble scale,
+                                      VideoOutputCrop crop,
                                       gpointer context);
 
 #define VIDEO_OUTPUT_TYPE (video_output_get_type())
@@ -56,12 +123,25 @@ G_DECLARE_FINAL_TYPE(VideoOutput,
  * @param height Preferred height of the video. Pass `NULL` for using texture
  * dimensions based on video's resolution.
  * @param enable_hardware_acceleration Whether to enable hardware acceleration.
+ * @param render_thread Existing |RenderThread| to render on (shared with other
+ * |VideoOutput|s) or NULL to create a dedicated one.
+ * @param prewarmed Pre-initialized resources to adopt (unless |render_thread|
+ * is passed) or NULL to create them.
  * @return VideoOutput*
  */
 VideoOutput* video_output_new(FlTextureRegistrar* texture_registrar,
                               FlView* view,
                               gint64 handle,
-                              VideoOutputConfiguration configuration);
+                              VideoOutputConfiguration configuration,
+                              RenderThread* render_thread,
+                              VideoOutputPrewarmed* prewarmed);
+
+/**
+ * @brief Returns the EGL config of Flutter's |egl_context| (on |egl_display|),
+ * which the isolated EGL contexts are created from, or NULL if unavailable.
+ */
+EGLConfig video_output_get_flutter_egl_config(EGLDisplay egl_display,
+                                              EGLContext egl_context);
 
 /**
  * @brief Sets the callback invoked when the texture ID updates i.e. video
@@ -88,17 +168,167 @@ void video_output_set_texture_update_callback(
  */
 void video_output_set_size(VideoOutput* self, gint64 width, gint64 height);
 
+/**
+ * @brief Sets the size (in physical pixels) at which the video output is
+ * displayed. The video output is then rendered at most at this size, while
+ * maintaining aspect ratio.
+ *
+ * @param width Displayed width of the video. Pass `0` to remove the limit.
+ * @param height Displayed height of the video. Pass `0` to remove the limit.
+ */
+void video_output_set_display_size(VideoOutput* self,
+                                   gint64 width,
+                                   gint64 height);
+
+/**
+ * @brief Sets whether the video output is visible (e.g. not scrolled out of
+ * view or covered). While hidden, new video frames are consumed without being
+ * rendered (playback continues), unless rendered frames are consumed otherwise
+ * e.g. by mirrors or a mosaic. The newest frame is rendered once visible again.
+ */
+void video_output_set_visible(VideoOutput* self, gboolean visible);
+
+/**
+ * @brief Sets the region of the video which is visible e.g. not clipped by
+ * `BoxFit.cover`. Only this region is rendered (through mpv's "video-zoom" &
+ * "video-pan-x"/"video-pan-y", combined with the player's own values & restored
+ * once the crop is removed) into a correspondingly smaller texture. Applied on
+ * the render thread, the texture's size changes once mpv applied the crop. Has
+ * no effect if a fixed size is set.
+ *
+ * @param crop Normalized region. Pass {0.0, 0.0, 1.0, 1.0} to remove the crop.
+ */
+void video_output_set_crop(VideoOutput* self, VideoOutputCrop crop);
+
+/**
+ * @brief Returns the region of the video currently rendered.
+ */
+VideoOutputCrop video_output_get_crop(VideoOutput* self);
+
+gboolean video_output_crop_equal(VideoOutputCrop a, VideoOutputCrop b);
+
 mpv_render_context* video_output_get_render_context(VideoOutput* self);
 
+VideoOutputConfiguration video_output_get_configuration(VideoOutput* self);
+
+/**
+ * @brief Returns the per-frame latency ring or NULL if frame latency is not
+ * measured (see |VideoOutputConfiguration::measure_frame_latency|).
+ */
+FrameLatency* video_output_get_frame_latency(VideoOutput* self);
+
+/**
+ * @brief Creates & registers an additional texture showing the same video
+ * frames as this |VideoOutput|, without any additional rendering.
+ *
+ * @return Texture ID of the mirror or -1 if S/W rendering is used or the
+ * maximum number of mirrors is reached.
+ */
+gint64 video_output_create_mirror(VideoOutput* self);
+
+/**
+ * @brief Unregisters & disposes the mirror with texture ID |id|.
+ */
+void video_output_dispose_mirror(VideoOutput* self, gint64 id);
+
+/**
+ * @brief Sets the callback receiving rendered video frames as dma-bufs. Pass
+ * NULL |callback| to stop.
+ * The previous callback is not invoked again once this returns.
+ *
+ * @return |MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_NOT_SUPPORTED| if S/W rendering is
+ * used or the driver cannot export dma-bufs.
+ */
+MediaKitVideoDmaBufExportResult video_output_set_dma_buf_frame_callback(
+    VideoOutput* self,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context);
+
+/**
+ * @brief Releases the dma-buf frame with |id| held by the consumer.
+ */
+void video_output_release_dma_buf_frame(VideoOutput* self, guint64 id);
+
+/**
+ * @brief Sets the callback receiving rendered video frames read back to CPU
+ * memory. Pass NULL |callback| to stop. The previous callback is not invoked
+ * again once this returns.
+ *
+ * @return |MEDIA_KIT_VIDEO_FRAME_TAP_NOT_SUPPORTED| if S/W rendering or the
+ * RGBA16F render format is used.
+ */
+MediaKitVideoFrameTapResult video_output_set_frame_tap_callback(
+    VideoOutput* self,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context);
+
+/**
+ * @brief Returns the presentation timestamp (in seconds) of the current video
+ * frame or -1 if unknown. Queries mpv, not meant to be called per-frame unless
+ * required by a consumer.
+ */
+gdouble video_output_get_video_pts(VideoOutput* self);
+
 GdkGLContext* video_output_get_gdk_gl_context(VideoOutput* self);
 
 EGLDisplay video_output_get_egl_display(VideoOutput* self);
 
 EGLContext video_output_get_egl_context(VideoOutput* self);
 
+/**
+ * @brief Returns the |RenderThread| used for H/W rendering or NULL if S/W
+ * rendering is used.
+ */
+RenderThread* video_output_get_render_thread(VideoOutput* self);
+
+/**
+ * @brief Adds |callback| to be invoked on the render thread after every newly
+ * rendered frame (H/W only). Must be called on the render thread.
+ */
+void video_output_add_frame_callback(VideoOutput* self,
+                                     RenderThreadCallback callback,
+                                     gpointer context);
+
+/**
+ * @brief Removes |callback| added through |video_output_add_frame_callback|.
+ * Must be called on the render thread.
+ */
+void video_output_remove_frame_callback(VideoOutput* self,
+                                        RenderThreadCallback callback,
+                                        gpointer context);
+
+/**
+ * @brief Retrieves the FBO holding the newest rendered frame (at its
+ * top-left), its dimensions & a serial incremented with every rendered frame.
+ * Must be called on the render thread; the FBO remains valid until the next
+ * render. Returns FALSE if no frame was rendered yet or S/W rendering is used.
+ */
+gboolean video_output_get_frame(VideoOutput* self,
+                                guint32* fbo,
+                                guint32* width,
+                                guint32* height,
+                                guint64* serial);
+
 EGLSurface video_output_get_egl_surface(VideoOutput* self);
 
-guint8* video_output_get_pixel_buffer(VideoOutput* self);
+/**
+ * @brief Takes the newest completely rendered S/W frame for Flutter, which
+ * holds it until the next call. The frame is never written meanwhile (pixel
+ * buffers are triple-buffered), no lock is held. Invoked on Flutter's raster
+ * thread.
+ *
+ * @param data Pixels (RGBA, tightly packed).
+ * @param width Width of the frame.
+ * @param height Height of the frame.
+ * @param crop Region of the video contained in the frame.
+ * @return FALSE if no frame was rendered yet.
+ */
+gboolean video_output_acquire_pixel_buffer(VideoOutput* self,
+                                           const guint8** data,
+                                           gint64* width,
+                                           gint64* height,
+                                           VideoOutputCrop* crop);
 
 gint64 video_output_get_width(VideoOutput* self);
 
@@ -106,6 +336,61 @@ gint64 video_output_get_height(VideoOutput* self);
 
 gint64 video_output_get_texture_id(VideoOutput* self);
 
-void video_output_notify_texture_update(VideoOutput* self);
+/**
+ * @brief Sets the bytes of GPU memory (render targets) or pixel buffer held by
+ * |VideoOutput|, updating the process-wide total & its high-water mark.
+ */
+void video_output_set_memory(VideoOutput* self, guint64 memory);
+
+/**
+ * @brief Returns the bytes of GPU memory (render targets) or pixel buffer held
+ * by |VideoOutput|.
+ */
+guint64 video_output_get_memory(VideoOutput* self);
+
+/**
+ * @brief Retrieves the bytes held by all |VideoOutput|s in the process & the
+ * highest value since the process started.
+ */
+void video_output_get_process_memory(guint64* memory, guint64* high_water_mark);
+
+/**
+ * @brief Returns render statistics of |VideoOutput| as a new |FlValue| map.
+ */
+FlValue* video_output_get_statistics(VideoOutput* self);
+
+/**
+ * @brief Returns percentiles of the time spent by recent frames in each stage
+ * of the pipeline as a new |FlValue| map. The map is empty if frame latency is
+ * not measured.
+ */
+FlValue* video_output_get_frame_latency_statistics(VideoOutput* self);
+
+/**
+ * @brief Notifies that Flutter took a newly rendered frame for presentation.
+ * Records the time to the first frame. With frame pacing (H/W), reports the
+ * swap to mpv & updates late/judder counters. Invoked on Flutter's raster
+ * thread.
+ *
+ * @param target_time mpv's target time (see |mpv_get_time_us|) of the frame or
+ * 0 if unknown.
+ */
+void video_output_notify_present(VideoOutput* self, gint64 target_time);
+
+/**
+ * @brief Notifies the texture update callback about the current dimensions.
+ *
+ * @param width Width of the video frame.
+ * @param height Height of the video frame.
+ * @param texture_width Width of the texture containing the video frame.
+ * @param texture_height Height of the texture containing the video frame.
+ * @param crop Region of the video contained in the video frame.
+ */
+void video_output_notify_texture_update(VideoOutput* self,
+                                        gint64 width,
+                                        gint64 height,
+                                        gint64 texture_width,
+                                        gint64 texture_height,
+                                        VideoOutputCrop crop);
 
 #endif  // VIDEO_OUTPUT_H_
\ No newline at end of file
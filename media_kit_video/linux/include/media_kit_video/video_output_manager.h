@@ -9,8 +9,19 @@
 #ifndef VIDEO_OUTPUT_MANAGER_H_
 #define VIDEO_OUTPUT_MANAGER_H_
 
+#include "texture_mosaic.h"
 #include "video_output.h"
 
+// What happens to a new |VideoOutput| whose (estimated) memory would exceed the
+// memory limit (see |video_output_manager_set_memory_limit|).
+typedef enum _VideoOutputMemoryLimitPolicy {
+  // Not created.
+  VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_REJECT,
+  // Rendered at a size fitting the remaining memory i.e. within a memory
+  // budget (H/W) or a lowered size cap (S/W). Rejected if nothing remains.
+  VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_DOWNSIZE,
+} VideoOutputMemoryLimitPolicy;
+
 #define VIDEO_OUTPUT_MANAGER_TYPE (video_output_manager_get_type())
 
 // Creates & disposes |VideoOutput| instances for video embedding.
@@ -42,8 +53,9 @@ VideoOutputManager* video_output_manager_new(
  * i.e. video dimensions changes.
  * @param texture_update_callback_context Context passed to
  * |texture_update_callback|.
+ * @return FALSE if rejected as per the memory limit.
  */
-void video_output_manager_create(VideoOutputManager* self,
+gboolean video_output_manager_create(VideoOutputManager* self,
                                  gint64 handle,
                                  VideoOutputConfiguration configuration,
                                  TextureUpdateCallback texture_update_callback,
@@ -64,6 +76,195 @@ void video_output_manager_set_size(VideoOutputManager* self,
                                    gint64 width,
                                    gint64 height);
 
+/**
+ * @brief Sets the size (in physical pixels) at which |VideoOutput| for given
+ * |handle| is displayed. The video output is then rendered at most at this
+ * size, while maintaining aspect ratio.
+ *
+ * @param width Displayed width of the video. Pass `0` to remove the limit.
+ * @param height Displayed height of the video. Pass `0` to remove the limit.
+ */
+void video_output_manager_set_display_size(VideoOutputManager* self,
+                                           gint64 handle,
+                                           gint64 width,
+                                           gint64 height);
+
+/**
+ * @brief Sets the visible region of the video for |VideoOutput| for given
+ * |handle|. Only this region is rendered.
+ *
+ * @param crop Normalized region. Pass {0.0, 0.0, 1.0, 1.0} to remove the crop.
+ */
+void video_output_manager_set_crop(VideoOutputManager* self,
+                                   gint64 handle,
+                                   VideoOutputCrop crop);
+
+/**
+ * @brief Returns render statistics of |VideoOutput| for given |handle| as a new
+ * |FlValue| map. The map is empty if no |VideoOutput| exists for |handle|.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ */
+FlValue* video_output_manager_get_statistics(VideoOutputManager* self,
+                                             gint64 handle);
+
+/**
+ * @brief Returns per-stage frame latency percentiles of |VideoOutput| for given
+ * |handle| as a new |FlValue| map. The map is empty if no |VideoOutput| exists
+ * for |handle| or it does not measure frame latency.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ */
+FlValue* video_output_manager_get_frame_latency(VideoOutputManager* self,
+                                                gint64 handle);
+
+/**
+ * @brief Sets whether |VideoOutput| for given |handle| is visible. Hidden video
+ * outputs do not render new video frames.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ * @param visible Whether the video output is visible.
+ */
+void video_output_manager_set_visible(VideoOutputManager* self,
+                                      gint64 handle,
+                                      gboolean visible);
+
+/**
+ * @brief Creates an additional texture mirroring |VideoOutput| for given
+ * |handle|. Returns the texture ID of the mirror or -1 if not possible.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ */
+gint64 video_output_manager_create_mirror(VideoOutputManager* self,
+                                          gint64 handle);
+
+/**
+ * @brief Disposes the mirror with texture ID |id| of |VideoOutput| for given
+ * |handle|.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ * @param id Texture ID of the mirror.
+ */
+void video_output_manager_dispose_mirror(VideoOutputManager* self,
+                                         gint64 handle,
+                                         gint64 id);
+
+/**
+ * @brief Sets the callback receiving rendered video frames of |VideoOutput|
+ * for given |handle| as dma-bufs. Pass NULL |callback| to stop.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ */
+MediaKitVideoDmaBufExportResult
+video_output_manager_set_dma_buf_frame_callback(
+    VideoOutputManager* self,
+    gint64 handle,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context);
+
+/**
+ * @brief Releases the dma-buf frame with |id| of |VideoOutput| for given
+ * |handle|.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ * @param id ID of the frame.
+ */
+void video_output_manager_release_dma_buf_frame(VideoOutputManager* self,
+                                                gint64 handle,
+                                                guint64 id);
+
+/**
+ * @brief Sets the callback receiving rendered video frames of |VideoOutput|
+ * for given |handle| in CPU memory. Pass NULL |callback| to stop.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param handle |mpv_handle| reference casted to gint64.
+ */
+MediaKitVideoFrameTapResult video_output_manager_set_frame_tap_callback(
+    VideoOutputManager* self,
+    gint64 handle,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context);
+
+/**
+ * @brief Creates & registers a |width| x |height| |TextureMosaic| composing
+ * the video outputs of multiple handles into a single texture.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @return Texture ID of the mosaic or -1 if it could not be registered.
+ */
+gint64 video_output_manager_create_mosaic(VideoOutputManager* self,
+                                          gint64 width,
+                                          gint64 height);
+
+/**
+ * @brief Sets the tiles of the mosaic with texture ID |id|. Unknown handles
+ * are ignored. See |texture_mosaic_set_layout| for the rejected tiles.
+ *
+ * @param self |VideoOutputManager| reference.
+ * @param id Texture ID of the mosaic.
+ * @param handles |mpv_handle| references casted to gint64.
+ * @param rects Rectangles of the tiles (in pixels).
+ * @param count Number of tiles.
+ * @param rejected Filled with the handles of the rejected tiles (|count|
+ * entries at most).
+ * @return Number of rejected tiles.
+ */
+guint video_output_manager_set_mosaic_layout(VideoOutputManager* self,
+                                             gint64 id,
+                                             const gint64* handles,
+                                             const TextureMosaicRect* rects,
+                                             guint count,
+                                             gint64* rejected);
+
+/**
+ * @brief Returns composition statistics of the mosaic with texture ID |id|.
+ */
+FlValue* video_output_manager_get_mosaic_statistics(VideoOutputManager* self,
+                                                    gint64 id);
+
+/**
+ * @brief Unregisters & disposes the mosaic with texture ID |id|.
+ */
+void video_output_manager_dispose_mosaic(VideoOutputManager* self, gint64 id);
+
+/**
+ * @brief Sets the limit on the memory (render targets, pixel buffers & mosaic
+ * textures) held by all video outputs, enforced when new |VideoOutput|s are
+ * created as per |policy|. Existing |VideoOutput|s are not affected.
+ *
+ * @param limit Limit in bytes. Pass `0` to remove the limit.
+ */
+void video_output_manager_set_memory_limit(
+    VideoOutputManager* self,
+    guint64 limit,
+    VideoOutputMemoryLimitPolicy policy);
+
+/**
+ * @brief Returns the memory held by video outputs (in total, per |VideoOutput|
+ * by handle & by mosaics), the process-wide high-water mark & the memory limit
+ * as a new |FlValue| map.
+ */
+FlValue* video_output_manager_get_memory_statistics(VideoOutputManager* self);
+
+/**
+ * @brief Sets the number of pre-warmed render contexts (render thread with its
+ * isolated EGL context & a texture registered with Flutter) kept ready for new
+ * H/W |VideoOutput|s not using the shared render thread. Adopted entries are
+ * replaced once idle. Must be called on the platform thread.
+ *
+ * @param size Number of entries (at most 8). Pass `0` to release the pool.
+ */
+void video_output_manager_set_pool_size(VideoOutputManager* self, guint size);
+
 /**
  * @brief Disposes |VideoOutput| instance for given |handle|.
  *
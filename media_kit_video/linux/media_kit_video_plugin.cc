@@ -28,6 +28,9 @@ struct _MediaKitVideoPlugin {
 
 G_DEFINE_TYPE(MediaKitVideoPlugin, media_kit_video_plugin, g_object_get_type())
 
+// Used by the exported native API (not owned).
+static MediaKitVideoPlugin* media_kit_video_plugin_instance = NULL;
+
 static void media_kit_video_plugin_handle_method_call(
     MediaKitVideoPlugin* self,
     FlMethodCall* method_call) {
@@ -48,6 +51,22 @@ static void media_kit_video_plugin_handle_method_call(
         fl_value_get_string(fl_value_lookup_string(configuration, "height"));
     const bool configuration_enable_hardware_acceleration = fl_value_get_bool(
         fl_value_lookup_string(configuration, "enableHardwareAcceleration"));
+    FlValue* configuration_shared_render_context =
+        fl_value_lookup_string(configuration, "sharedRenderContext");
+    FlValue* configuration_render_budget =
+        fl_value_lookup_string(configuration, "renderBudget");
+    FlValue* configuration_render_format =
+        fl_value_lookup_string(configuration, "renderFormat");
+    FlValue* configuration_frame_pacing =
+        fl_value_lookup_string(configuration, "framePacing");
+    FlValue* configuration_measure_frame_latency =
+        fl_value_lookup_string(configuration, "measureFrameLatency");
+    FlValue* configuration_software_max_width =
+        fl_value_lookup_string(configuration, "softwareMaxWidth");
+    FlValue* configuration_software_max_height =
+        fl_value_lookup_string(configuration, "softwareMaxHeight");
+    FlValue* configuration_max_fps =
+        fl_value_lookup_string(configuration, "maxFps");
 
     if (g_strcmp0(configuration_width, "null") != 0) {
       configuration_value.width =
@@ -59,6 +78,47 @@ static void media_kit_video_plugin_handle_method_call(
     }
     configuration_value.enable_hardware_acceleration =
         configuration_enable_hardware_acceleration;
+    configuration_value.shared_render_thread =
+        configuration_shared_render_context != NULL &&
+        fl_value_get_bool(configuration_shared_render_context);
+    if (configuration_render_budget != NULL &&
+        g_strcmp0(fl_value_get_string(configuration_render_budget), "null") !=
+            0) {
+      configuration_value.render_budget = g_ascii_strtoll(
+          fl_value_get_string(configuration_render_budget), NULL, 10);
+    }
+    if (configuration_render_format != NULL) {
+      const gchar* format = fl_value_get_string(configuration_render_format);
+      if (g_strcmp0(format, "rgb10a2") == 0) {
+        configuration_value.format = VIDEO_OUTPUT_FORMAT_RGB10_A2;
+      } else if (g_strcmp0(format, "rgba16f") == 0) {
+        configuration_value.format = VIDEO_OUTPUT_FORMAT_RGBA16F;
+      }
+    }
+
+    configuration_value.frame_pacing =
+        configuration_frame_pacing != NULL &&
+        fl_value_get_bool(configuration_frame_pacing);
+    configuration_value.measure_frame_latency =
+        configuration_measure_frame_latency != NULL &&
+        fl_value_get_bool(configuration_measure_frame_latency);
+    if (configuration_software_max_width != NULL &&
+        configuration_software_max_height != NULL &&
+        g_strcmp0(fl_value_get_string(configuration_software_max_width),
+                  "null") != 0 &&
+        g_strcmp0(fl_value_get_string(configuration_software_max_height),
+                  "null") != 0) {
+      configuration_value.sw_max_width = g_ascii_strtoll(
+          fl_value_get_string(configuration_software_max_width), NULL, 10);
+      configuration_value.sw_max_height = g_ascii_strtoll(
+          fl_value_get_string(configuration_software_max_height), NULL, 10);
+    }
+    if (configuration_max_fps != NULL &&
+        g_strcmp0(fl_value_get_string(configuration_max_fps), "null") != 0) {
+      configuration_value.max_fps = MAX(
+          g_ascii_strtod(fl_value_get_string(configuration_max_fps), NULL),
+          0.0);
+    }
 
     typedef struct _VideoOutputTextureUpdateCallbackData {
       FlMethodChannel* channel;
@@ -69,9 +129,11 @@ static void media_kit_video_plugin_handle_method_call(
         g_new0(VideoOutputTextureUpdateCallbackData, 1);
     data->channel = self->channel;
     data->handle = handle_value;
-    video_output_manager_create(
+    gboolean created = video_output_manager_create(
         self->video_output_manager, handle_value, configuration_value,
-        [](gint64 id, gint64 width, gint64 height, gpointer context) {
+        [](gint64 id, gint64 width, gint64 height, gint64 texture_width,
+           gint64 texture_height, gdouble scale, VideoOutputCrop crop,
+           gpointer context) {
           auto data = (VideoOutputTextureUpdateCallbackData*)context;
           FlMethodChannel* channel = data->channel;
           gint64 handle = data->handle;
@@ -84,6 +146,25 @@ static void media_kit_video_plugin_handle_method_call(
           fl_value_set_string_take(result, "handle", fl_value_new_int(handle));
           fl_value_set_string_take(result, "id", fl_value_new_int(id));
           fl_value_set_string_take(result, "rect", rect);
+          fl_value_set_string_take(result, "textureWidth",
+                                   fl_value_new_int(texture_width));
+          fl_value_set_string_take(result, "textureHeight",
+                                   fl_value_new_int(texture_height));
+          fl_value_set_string_take(result, "scale",
+                                   fl_value_new_float(scale));
+          // Region of the video contained in the frame, only if cropped.
+          if (crop.width < 1.0 || crop.height < 1.0) {
+            FlValue* crop_map = fl_value_new_map();
+            fl_value_set_string_take(crop_map, "left",
+                                     fl_value_new_float(crop.left));
+            fl_value_set_string_take(crop_map, "top",
+                                     fl_value_new_float(crop.top));
+            fl_value_set_string_take(crop_map, "width",
+                                     fl_value_new_float(crop.width));
+            fl_value_set_string_take(crop_map, "height",
+                                     fl_value_new_float(crop.height));
+            fl_value_set_string_take(result, "crop", crop_map);
+          }
           
           typedef struct {
             FlMethodChannel* channel;
@@ -104,8 +185,15 @@ static void media_kit_video_plugin_handle_method_call(
           }, idle_data);
         },
         data);
-    FlValue* result = fl_value_new_null();
-    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    if (created) {
+      FlValue* result = fl_value_new_null();
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    } else {
+      g_free(data);
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "MemoryLimitExceeded", "Video output exceeds the memory limit.",
+          NULL));
+    }
   } else if (g_strcmp0(method, "VideoOutputManager.SetSize") == 0) {
     FlValue* arguments = fl_method_call_get_args(method_call);
     FlValue* handle = fl_value_lookup_string(arguments, "handle");
@@ -125,6 +213,192 @@ static void media_kit_video_plugin_handle_method_call(
                                   width_value, height_value);
     FlValue* result = fl_value_new_null();
     response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.SetDisplaySize") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* handle = fl_value_lookup_string(arguments, "handle");
+    FlValue* width = fl_value_lookup_string(arguments, "width");
+    FlValue* height = fl_value_lookup_string(arguments, "height");
+    gint64 handle_value =
+        g_ascii_strtoll(fl_value_get_string(handle), NULL, 10);
+    gint64 width_value = 0;
+    gint64 height_value = 0;
+    if (g_strcmp0(fl_value_get_string(width), "null") != 0) {
+      width_value = g_ascii_strtoll(fl_value_get_string(width), NULL, 10);
+    }
+    if (g_strcmp0(fl_value_get_string(height), "null") != 0) {
+      height_value = g_ascii_strtoll(fl_value_get_string(height), NULL, 10);
+    }
+    video_output_manager_set_display_size(self->video_output_manager,
+                                          handle_value, width_value,
+                                          height_value);
+    FlValue* result = fl_value_new_null();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.SetCrop") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* handle = fl_value_lookup_string(arguments, "handle");
+    FlValue* left = fl_value_lookup_string(arguments, "left");
+    FlValue* top = fl_value_lookup_string(arguments, "top");
+    FlValue* width = fl_value_lookup_string(arguments, "width");
+    FlValue* height = fl_value_lookup_string(arguments, "height");
+    gint64 handle_value =
+        g_ascii_strtoll(fl_value_get_string(handle), NULL, 10);
+    VideoOutputCrop crop_value = {0.0, 0.0, 1.0, 1.0};
+    if (g_strcmp0(fl_value_get_string(width), "null") != 0 &&
+        g_strcmp0(fl_value_get_string(height), "null") != 0) {
+      crop_value.left = g_ascii_strtod(fl_value_get_string(left), NULL);
+      crop_value.top = g_ascii_strtod(fl_value_get_string(top), NULL);
+      crop_value.width = g_ascii_strtod(fl_value_get_string(width), NULL);
+      crop_value.height = g_ascii_strtod(fl_value_get_string(height), NULL);
+    }
+    video_output_manager_set_crop(self->video_output_manager, handle_value,
+                                  crop_value);
+    FlValue* result = fl_value_new_null();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.SetVisible") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* handle = fl_value_lookup_string(arguments, "handle");
+    FlValue* visible = fl_value_lookup_string(arguments, "visible");
+    gint64 handle_value =
+        g_ascii_strtoll(fl_value_get_string(handle), NULL, 10);
+    gboolean visible_value =
+        g_strcmp0(fl_value_get_string(visible), "false") != 0;
+    video_output_manager_set_visible(self->video_output_manager, handle_value,
+                                     visible_value);
+    FlValue* result = fl_value_new_null();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.GetStatistics") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* handle = fl_value_lookup_string(arguments, "handle");
+    gint64 handle_value =
+        g_ascii_strtoll(fl_value_get_string(handle), NULL, 10);
+    FlValue* result = video_output_manager_get_statistics(
+        self->video_output_manager, handle_value);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.GetFrameLatency") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* handle = fl_value_lookup_string(arguments, "handle");
+    gint64 handle_value =
+        g_ascii_strtoll(fl_value_get_string(handle), NULL, 10);
+    FlValue* result = video_output_manager_get_frame_latency(
+        self->video_output_manager, handle_value);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.CreateMirror") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* handle = fl_value_lookup_string(arguments, "handle");
+    gint64 handle_value =
+        g_ascii_strtoll(fl_value_get_string(handle), NULL, 10);
+    gint64 id = video_output_manager_create_mirror(self->video_output_manager,
+                                                   handle_value);
+    FlValue* result = id == -1 ? fl_value_new_null() : fl_value_new_int(id);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.DisposeMirror") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* handle = fl_value_lookup_string(arguments, "handle");
+    FlValue* id = fl_value_lookup_string(arguments, "id");
+    gint64 handle_value =
+        g_ascii_strtoll(fl_value_get_string(handle), NULL, 10);
+    gint64 id_value = g_ascii_strtoll(fl_value_get_string(id), NULL, 10);
+    video_output_manager_dispose_mirror(self->video_output_manager,
+                                        handle_value, id_value);
+    FlValue* result = fl_value_new_null();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.CreateMosaic") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* width = fl_value_lookup_string(arguments, "width");
+    FlValue* height = fl_value_lookup_string(arguments, "height");
+    gint64 width_value = g_ascii_strtoll(fl_value_get_string(width), NULL, 10);
+    gint64 height_value =
+        g_ascii_strtoll(fl_value_get_string(height), NULL, 10);
+    gint64 id = video_output_manager_create_mosaic(
+        self->video_output_manager, width_value, height_value);
+    FlValue* result = id == -1 ? fl_value_new_null() : fl_value_new_int(id);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.SetMosaicLayout") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* id = fl_value_lookup_string(arguments, "id");
+    FlValue* tiles = fl_value_lookup_string(arguments, "tiles");
+    gint64 id_value = g_ascii_strtoll(fl_value_get_string(id), NULL, 10);
+    guint count = (guint)fl_value_get_length(tiles);
+    g_autofree gint64* handles = g_new0(gint64, count);
+    g_autofree TextureMosaicRect* rects = g_new0(TextureMosaicRect, count);
+    for (guint i = 0; i < count; i++) {
+      FlValue* tile = fl_value_get_list_value(tiles, i);
+      const gchar* keys[] = {"left", "top", "width", "height"};
+      gint32* values[] = {&rects[i].left, &rects[i].top, &rects[i].width,
+                          &rects[i].height};
+      handles[i] = g_ascii_strtoll(
+          fl_value_get_string(fl_value_lookup_string(tile, "handle")), NULL,
+          10);
+      for (gint j = 0; j < 4; j++) {
+        *values[j] = (gint32)g_ascii_strtoll(
+            fl_value_get_string(fl_value_lookup_string(tile, keys[j])), NULL,
+            10);
+      }
+    }
+    g_autofree gint64* rejected = g_new0(gint64, count);
+    guint rejected_count = video_output_manager_set_mosaic_layout(
+        self->video_output_manager, id_value, handles, rects, count, rejected);
+    if (rejected_count == 0) {
+      FlValue* result = fl_value_new_null();
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    } else {
+      // Tiles which cannot be composed e.g. not rendered on the mosaic's
+      // render thread.
+      g_autoptr(GString) message = g_string_new("Tiles cannot be composed:");
+      FlValue* details = fl_value_new_list();
+      for (guint i = 0; i < rejected_count; i++) {
+        g_string_append_printf(message, " %" G_GINT64_FORMAT, rejected[i]);
+        fl_value_append_take(details, fl_value_new_int(rejected[i]));
+      }
+      g_string_append(message, ".");
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "MosaicTilesRejected", message->str, details));
+      fl_value_unref(details);
+    }
+  } else if (g_strcmp0(method, "VideoOutputManager.GetMosaicStatistics") ==
+             0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* id = fl_value_lookup_string(arguments, "id");
+    gint64 id_value = g_ascii_strtoll(fl_value_get_string(id), NULL, 10);
+    FlValue* result = video_output_manager_get_mosaic_statistics(
+        self->video_output_manager, id_value);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.SetMemoryLimit") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* limit = fl_value_lookup_string(arguments, "limit");
+    FlValue* policy = fl_value_lookup_string(arguments, "policy");
+    guint64 limit_value = 0;
+    if (g_strcmp0(fl_value_get_string(limit), "null") != 0) {
+      limit_value = g_ascii_strtoull(fl_value_get_string(limit), NULL, 10);
+    }
+    VideoOutputMemoryLimitPolicy policy_value =
+        g_strcmp0(fl_value_get_string(policy), "downsize") == 0
+            ? VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_DOWNSIZE
+            : VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_REJECT;
+    video_output_manager_set_memory_limit(self->video_output_manager,
+                                          limit_value, policy_value);
+    FlValue* result = fl_value_new_null();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.SetPoolSize") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* size = fl_value_lookup_string(arguments, "size");
+    gint64 size_value = g_ascii_strtoll(fl_value_get_string(size), NULL, 10);
+    video_output_manager_set_pool_size(self->video_output_manager,
+                                       (guint)MAX(size_value, 0));
+    FlValue* result = fl_value_new_null();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.GetMemoryStatistics") ==
+             0) {
+    FlValue* result =
+        video_output_manager_get_memory_statistics(self->video_output_manager);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else if (g_strcmp0(method, "VideoOutputManager.DisposeMosaic") == 0) {
+    FlValue* arguments = fl_method_call_get_args(method_call);
+    FlValue* id = fl_value_lookup_string(arguments, "id");
+    gint64 id_value = g_ascii_strtoll(fl_value_get_string(id), NULL, 10);
+    video_output_manager_dispose_mosaic(self->video_output_manager, id_value);
+    FlValue* result = fl_value_new_null();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
   } else if (g_strcmp0(method, "VideoOutputManager.Dispose") == 0) {
     FlValue* arguments = fl_method_call_get_args(method_call);
     FlValue* handle = fl_value_lookup_string(arguments, "handle");
@@ -151,6 +425,9 @@ static void media_kit_video_plugin_handle_method_call(
 }
 
 static void media_kit_video_plugin_dispose(GObject* object) {
+  if (media_kit_video_plugin_instance == MEDIA_KIT_VIDEO_PLUGIN(object)) {
+    media_kit_video_plugin_instance = NULL;
+  }
   G_OBJECT_CLASS(media_kit_video_plugin_parent_class)->dispose(object);
 }
 
@@ -187,6 +464,7 @@ static MediaKitVideoPlugin* media_kit_video_plugin_new(
   self->view = view;
   self->video_output_manager =
       video_output_manager_new(texture_registrar, view);
+  media_kit_video_plugin_instance = self;
   return self;
 }
 
@@ -195,6 +473,40 @@ void media_kit_video_plugin_register_with_registrar(
   media_kit_video_plugin_new(registrar);
 }
 
+MediaKitVideoDmaBufExportResult
+media_kit_video_plugin_set_dma_buf_frame_callback(
+    gint64 handle,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context) {
+  if (media_kit_video_plugin_instance == NULL) {
+    return MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_NOT_FOUND;
+  }
+  return video_output_manager_set_dma_buf_frame_callback(
+      media_kit_video_plugin_instance->video_output_manager, handle, callback,
+      context);
+}
+
+void media_kit_video_plugin_release_dma_buf_frame(gint64 handle, guint64 id) {
+  if (media_kit_video_plugin_instance == NULL) {
+    return;
+  }
+  video_output_manager_release_dma_buf_frame(
+      media_kit_video_plugin_instance->video_output_manager, handle, id);
+}
+
+MediaKitVideoFrameTapResult media_kit_video_plugin_set_frame_tap_callback(
+    gint64 handle,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context) {
+  if (media_kit_video_plugin_instance == NULL) {
+    return MEDIA_KIT_VIDEO_FRAME_TAP_NOT_FOUND;
+  }
+  return video_output_manager_set_frame_tap_callback(
+      media_kit_video_plugin_instance->video_output_manager, handle,
+      configuration, callback, context);
+}
+
 #else
 
 #include <iostream>
@@ -205,4 +517,22 @@ void media_kit_video_plugin_register_with_registrar(
             << std::endl;
 }
 
+MediaKitVideoDmaBufExportResult
+media_kit_video_plugin_set_dma_buf_frame_callback(
+    gint64 handle,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context) {
+  return MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_NOT_SUPPORTED;
+}
+
+void media_kit_video_plugin_release_dma_buf_frame(gint64 handle, guint64 id) {}
+
+MediaKitVideoFrameTapResult media_kit_video_plugin_set_frame_tap_callback(
+    gint64 handle,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context) {
+  return MEDIA_KIT_VIDEO_FRAME_TAP_NOT_SUPPORTED;
+}
+
 #endif
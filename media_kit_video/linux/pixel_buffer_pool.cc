@@ -0,0 +1,133 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#include "include/media_kit_video/pixel_buffer_pool.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+
+typedef struct _PixelBufferPoolEntry {
+  guint8* data;
+  gsize capacity;
+} PixelBufferPoolEntry;
+
+static GMutex pixel_buffer_pool_mutex;
+static GArray* pixel_buffer_pool_entries = NULL; /* Oldest first. */
+static guint64 pixel_buffer_pool_memory = 0;
+static guint64 pixel_buffer_pool_hits = 0;
+static guint64 pixel_buffer_pool_misses = 0;
+
+gsize pixel_buffer_pool_get_capacity(gsize size) {
+  if (size >= PIXEL_BUFFER_POOL_HUGEPAGE_SIZE) {
+    return (size + PIXEL_BUFFER_POOL_HUGEPAGE_SIZE - 1) /
+           PIXEL_BUFFER_POOL_HUGEPAGE_SIZE * PIXEL_BUFFER_POOL_HUGEPAGE_SIZE;
+  }
+  gsize capacity = PIXEL_BUFFER_POOL_MIN_CAPACITY;
+  while (capacity < size) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+static guint8* pixel_buffer_pool_allocate(gsize capacity) {
+  // Hugepage-sized buffers are aligned to the hugepage size so that the
+  // kernel can back them with transparent hugepages (fewer TLB misses while
+  // mpv writes & Flutter uploads whole frames). Smaller ones to cache lines.
+  gsize alignment = capacity >= PIXEL_BUFFER_POOL_HUGEPAGE_SIZE
+                        ? PIXEL_BUFFER_POOL_HUGEPAGE_SIZE
+                        : 64;
+  void* data = NULL;
+  if (posix_memalign(&data, alignment, capacity) != 0) {
+    g_error("media_kit: PixelBufferPool: Failed to allocate %" G_GSIZE_FORMAT
+            " bytes.",
+            capacity);
+  }
+#ifdef MADV_HUGEPAGE
+  if (alignment == PIXEL_BUFFER_POOL_HUGEPAGE_SIZE) {
+    madvise(data, capacity, MADV_HUGEPAGE);
+  }
+#endif
+  return (guint8*)data;
+}
+
+guint8* pixel_buffer_pool_acquire(gsize size) {
+  gsize capacity = pixel_buffer_pool_get_capacity(size);
+  guint8* data = NULL;
+  g_mutex_lock(&pixel_buffer_pool_mutex);
+  if (pixel_buffer_pool_entries != NULL) {
+    // Most recently released first i.e. most likely still cache/TLB warm.
+    for (gint i = (gint)pixel_buffer_pool_entries->len - 1; i >= 0; i--) {
+      PixelBufferPoolEntry* entry =
+          &g_array_index(pixel_buffer_pool_entries, PixelBufferPoolEntry, i);
+      if (entry->capacity == capacity) {
+        data = entry->data;
+        pixel_buffer_pool_memory -= capacity;
+        g_array_remove_index(pixel_buffer_pool_entries, i);
+        break;
+      }
+    }
+  }
+  if (data != NULL) {
+    pixel_buffer_pool_hits++;
+  } else {
+    pixel_buffer_pool_misses++;
+  }
+  g_mutex_unlock(&pixel_buffer_pool_mutex);
+  if (data == NULL) {
+    data = pixel_buffer_pool_allocate(capacity);
+  }
+  return data;
+}
+
+void pixel_buffer_pool_release(guint8* data, gsize capacity) {
+  if (data == NULL) {
+    return;
+  }
+  if (capacity > PIXEL_BUFFER_POOL_MAX_MEMORY) {
+    free(data);
+    return;
+  }
+  GArray* evicted = g_array_new(FALSE, FALSE, sizeof(PixelBufferPoolEntry));
+  g_mutex_lock(&pixel_buffer_pool_mutex);
+  if (pixel_buffer_pool_entries == NULL) {
+    pixel_buffer_pool_entries =
+        g_array_new(FALSE, FALSE, sizeof(PixelBufferPoolEntry));
+  }
+  PixelBufferPoolEntry entry{data, capacity};
+  g_array_append_val(pixel_buffer_pool_entries, entry);
+  pixel_buffer_pool_memory += capacity;
+  // Evict the least recently released buffers.
+  while (pixel_buffer_pool_memory > PIXEL_BUFFER_POOL_MAX_MEMORY) {
+    PixelBufferPoolEntry oldest =
+        g_array_index(pixel_buffer_pool_entries, PixelBufferPoolEntry, 0);
+    g_array_remove_index(pixel_buffer_pool_entries, 0);
+    pixel_buffer_pool_memory -= oldest.capacity;
+    g_array_append_val(evicted, oldest);
+  }
+  g_mutex_unlock(&pixel_buffer_pool_mutex);
+  for (guint i = 0; i < evicted->len; i++) {
+    free(g_array_index(evicted, PixelBufferPoolEntry, i).data);
+  }
+  g_array_free(evicted, TRUE);
+}
+
+FlValue* pixel_buffer_pool_get_statistics() {
+  g_mutex_lock(&pixel_buffer_pool_mutex);
+  guint64 memory = pixel_buffer_pool_memory;
+  guint buffers =
+      pixel_buffer_pool_entries != NULL ? pixel_buffer_pool_entries->len : 0;
+  guint64 hits = pixel_buffer_pool_hits;
+  guint64 misses = pixel_buffer_pool_misses;
+  g_mutex_unlock(&pixel_buffer_pool_mutex);
+  FlValue* statistics = fl_value_new_map();
+  fl_value_set_string_take(statistics, "memory", fl_value_new_int(memory));
+  fl_value_set_string_take(statistics, "buffers", fl_value_new_int(buffers));
+  fl_value_set_string_take(statistics, "hits", fl_value_new_int(hits));
+  fl_value_set_string_take(statistics, "misses", fl_value_new_int(misses));
+  return statistics;
+}
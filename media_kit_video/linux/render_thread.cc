@@ -0,0 +1,301 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#include "include/media_kit_video/render_thread.h"
+
+typedef struct _RenderThreadRequest {
+  RenderThreadCallback callback;
+  gpointer data;
+  gint64 time; /* Monotonic time at which the request is due (0 i.e. now). */
+} RenderThreadRequest;
+
+typedef struct _RenderThreadInvocation {
+  RenderThreadCallback callback;
+  gpointer data;
+  gboolean done;
+} RenderThreadInvocation;
+
+struct _RenderThread {
+  GObject parent_instance;
+  GThread* thread;
+  GMutex mutex;
+  GCond cond;
+  EGLDisplay egl_display;
+  EGLContext egl_context;
+  GArray* requests;       /* Pending |RenderThreadRequest|s (coalesced). */
+  GPtrArray* invocations; /* Pending |RenderThreadInvocation|s. */
+  gboolean quit;
+  guint64 context_switches; /* eglMakeCurrent calls made on the thread. */
+  guint64 passes;           /* Batches of render requests processed. */
+  guint64 pass_renders;     /* Render requests processed in all passes. */
+  gint64 pass_time;         /* Total time spent in passes (microseconds). */
+  gint64 last_pass_time;
+  guint last_pass_renders;
+};
+
+G_DEFINE_TYPE(RenderThread, render_thread, G_TYPE_OBJECT)
+
+static gpointer render_thread_run(gpointer data) {
+  RenderThread* self = RENDER_THREAD(data);
+  // Without EGL context i.e. |render_thread_new_sw|.
+  gboolean egl = self->egl_context != EGL_NO_CONTEXT;
+  if (egl) {
+    // Bound API is per-thread state.
+    eglBindAPI(EGL_OPENGL_ES_API);
+    g_mutex_lock(&self->mutex);
+    self->context_switches++;
+    g_mutex_unlock(&self->mutex);
+  }
+  if (egl && !eglMakeCurrent(self->egl_display, EGL_NO_SURFACE,
+                             EGL_NO_SURFACE, self->egl_context)) {
+    g_printerr(
+        "media_kit: RenderThread: Failed to make isolated EGL context "
+        "current. Error: 0x%x\n",
+        eglGetError());
+  }
+  GArray* requests =
+      g_array_new(FALSE, FALSE, sizeof(RenderThreadRequest));
+  g_mutex_lock(&self->mutex);
+  while (TRUE) {
+    // Blocking invocations take precedence over render requests.
+    if (self->invocations->len > 0) {
+      RenderThreadInvocation* invocation =
+          (RenderThreadInvocation*)g_ptr_array_remove_index(self->invocations,
+                                                            0);
+      g_mutex_unlock(&self->mutex);
+      invocation->callback(invocation->data);
+      g_mutex_lock(&self->mutex);
+      invocation->done = TRUE;
+      g_cond_broadcast(&self->cond);
+      continue;
+    }
+    // Take all due requests & render them back-to-back.
+    gint64 now = g_get_monotonic_time();
+    gint64 next = G_MAXINT64;
+    for (guint i = 0; i < self->requests->len;) {
+      RenderThreadRequest* request =
+          &g_array_index(self->requests, RenderThreadRequest, i);
+      if (request->time <= now) {
+        g_array_append_vals(requests, request, 1);
+        g_array_remove_index(self->requests, i);
+      } else {
+        next = MIN(next, request->time);
+        i++;
+      }
+    }
+    if (requests->len > 0) {
+      g_mutex_unlock(&self->mutex);
+      gint64 start = g_get_monotonic_time();
+      for (guint i = 0; i < requests->len; i++) {
+        RenderThreadRequest* request =
+            &g_array_index(requests, RenderThreadRequest, i);
+        request->callback(request->data);
+      }
+      gint64 elapsed = g_get_monotonic_time() - start;
+      g_mutex_lock(&self->mutex);
+      self->passes++;
+      self->pass_renders += requests->len;
+      self->pass_time += elapsed;
+      self->last_pass_time = elapsed;
+      self->last_pass_renders = requests->len;
+      g_array_set_size(requests, 0);
+      continue;
+    }
+    if (self->quit) {
+      break;
+    }
+    if (next != G_MAXINT64) {
+      g_cond_wait_until(&self->cond, &self->mutex, next);
+    } else {
+      g_cond_wait(&self->cond, &self->mutex);
+    }
+  }
+  g_mutex_unlock(&self->mutex);
+  g_array_unref(requests);
+  if (egl) {
+    eglMakeCurrent(self->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+    eglReleaseThread();
+  }
+  return NULL;
+}
+
+static void render_thread_dispose(GObject* object) {
+  RenderThread* self = RENDER_THREAD(object);
+  if (self->thread != NULL) {
+    g_mutex_lock(&self->mutex);
+    self->quit = TRUE;
+    g_cond_broadcast(&self->cond);
+    g_mutex_unlock(&self->mutex);
+    g_thread_join(self->thread);
+    self->thread = NULL;
+  }
+  if (self->egl_context != EGL_NO_CONTEXT) {
+    eglDestroyContext(self->egl_display, self->egl_context);
+    self->egl_context = EGL_NO_CONTEXT;
+  }
+  G_OBJECT_CLASS(render_thread_parent_class)->dispose(object);
+}
+
+static void render_thread_finalize(GObject* object) {
+  RenderThread* self = RENDER_THREAD(object);
+  g_array_unref(self->requests);
+  g_ptr_array_unref(self->invocations);
+  g_cond_clear(&self->cond);
+  g_mutex_clear(&self->mutex);
+  G_OBJECT_CLASS(render_thread_parent_class)->finalize(object);
+}
+
+static void render_thread_class_init(RenderThreadClass* klass) {
+  G_OBJECT_CLASS(klass)->dispose = render_thread_dispose;
+  G_OBJECT_CLASS(klass)->finalize = render_thread_finalize;
+}
+
+static void render_thread_init(RenderThread* self) {
+  self->thread = NULL;
+  self->egl_display = EGL_NO_DISPLAY;
+  self->egl_context = EGL_NO_CONTEXT;
+  self->requests = g_array_new(FALSE, FALSE, sizeof(RenderThreadRequest));
+  self->invocations = g_ptr_array_new();
+  self->quit = FALSE;
+  self->context_switches = 0;
+  self->passes = 0;
+  self->pass_renders = 0;
+  self->pass_time = 0;
+  self->last_pass_time = 0;
+  self->last_pass_renders = 0;
+  g_mutex_init(&self->mutex);
+  g_cond_init(&self->cond);
+}
+
+RenderThread* render_thread_new(EGLDisplay egl_display, EGLConfig egl_config) {
+  RenderThread* self =
+      RENDER_THREAD(g_object_new(render_thread_get_type(), NULL));
+  self->egl_display = egl_display;
+  // Bind OpenGL ES API (Flutter uses OpenGL ES on Linux)
+  eglBindAPI(EGL_OPENGL_ES_API);
+  // Create an isolated EGL context (NOT shared with Flutter)
+  // This prevents OpenGL state pollution and resource contention
+  EGLint context_attribs[] = {
+      EGL_CONTEXT_CLIENT_VERSION,
+      2,
+      EGL_NONE,
+  };
+  self->egl_context = eglCreateContext(self->egl_display, egl_config,
+                                       EGL_NO_CONTEXT, context_attribs);
+  if (self->egl_context == EGL_NO_CONTEXT) {
+    g_printerr(
+        "media_kit: RenderThread: Failed to create isolated EGL context. "
+        "Error: 0x%x\n",
+        eglGetError());
+    return self;
+  }
+  self->thread = g_thread_new("media_kit_render", render_thread_run, self);
+  return self;
+}
+
+RenderThread* render_thread_new_sw() {
+  RenderThread* self =
+      RENDER_THREAD(g_object_new(render_thread_get_type(), NULL));
+  self->thread = g_thread_new("media_kit_sw", render_thread_run, self);
+  return self;
+}
+
+EGLDisplay render_thread_get_egl_display(RenderThread* self) {
+  return self->egl_display;
+}
+
+EGLContext render_thread_get_egl_context(RenderThread* self) {
+  return self->egl_context;
+}
+
+void render_thread_invoke(RenderThread* self,
+                          RenderThreadCallback callback,
+                          gpointer data) {
+  if (self->thread == NULL || g_thread_self() == self->thread) {
+    callback(data);
+    return;
+  }
+  RenderThreadInvocation invocation{callback, data, FALSE};
+  g_mutex_lock(&self->mutex);
+  g_ptr_array_add(self->invocations, &invocation);
+  g_cond_broadcast(&self->cond);
+  while (!invocation.done) {
+    g_cond_wait(&self->cond, &self->mutex);
+  }
+  g_mutex_unlock(&self->mutex);
+}
+
+void render_thread_request_render(RenderThread* self,
+                                  RenderThreadCallback callback,
+                                  gpointer data) {
+  render_thread_request_render_at(self, callback, data, 0);
+}
+
+void render_thread_request_render_at(RenderThread* self,
+                                     RenderThreadCallback callback,
+                                     gpointer data,
+                                     gint64 time) {
+  if (self->thread == NULL) {
+    return;
+  }
+  g_mutex_lock(&self->mutex);
+  gboolean pending = FALSE;
+  for (guint i = 0; i < self->requests->len; i++) {
+    RenderThreadRequest* request =
+        &g_array_index(self->requests, RenderThreadRequest, i);
+    if (request->data == data) {
+      // Coalesced into the earlier of both.
+      if (time < request->time) {
+        request->time = time;
+        g_cond_broadcast(&self->cond);
+      }
+      pending = TRUE;
+      break;
+    }
+  }
+  if (!pending) {
+    RenderThreadRequest request{callback, data, time};
+    g_array_append_val(self->requests, request);
+    g_cond_broadcast(&self->cond);
+  }
+  g_mutex_unlock(&self->mutex);
+}
+
+void render_thread_cancel(RenderThread* self, gpointer data) {
+  g_mutex_lock(&self->mutex);
+  for (guint i = 0; i < self->requests->len;) {
+    if (g_array_index(self->requests, RenderThreadRequest, i).data == data) {
+      g_array_remove_index(self->requests, i);
+    } else {
+      i++;
+    }
+  }
+  g_mutex_unlock(&self->mutex);
+}
+
+void render_thread_get_statistics(RenderThread* self, FlValue* statistics) {
+  g_mutex_lock(&self->mutex);
+  fl_value_set_string_take(statistics, "renderThreadContextSwitches",
+                           fl_value_new_int(self->context_switches));
+  fl_value_set_string_take(statistics, "renderThreadPasses",
+                           fl_value_new_int(self->passes));
+  fl_value_set_string_take(
+      statistics, "renderThreadAverageRendersPerPass",
+      fl_value_new_float(self->passes > 0 ? (gdouble)self->pass_renders /
+                                                self->passes
+                                          : 0.0));
+  fl_value_set_string_take(
+      statistics, "renderThreadAveragePassTime",
+      fl_value_new_int(self->passes > 0 ? self->pass_time / self->passes : 0));
+  fl_value_set_string_take(statistics, "renderThreadLastPassTime",
+                           fl_value_new_int(self->last_pass_time));
+  fl_value_set_string_take(statistics, "renderThreadLastPassRenders",
+                           fl_value_new_int(self->last_pass_renders));
+  g_mutex_unlock(&self->mutex);
+}
@@ -10,6 +10,7 @@
 
 #include <epoxy/gl.h>
 #include <epoxy/egl.h>
+#include <unistd.h>
 
 // EGLImage extension function pointers
 typedef EGLImageKHR (*PFNEGLCREATEIMAGEKHRPROC)(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list);
@@ -27,24 +28,210 @@ static PFNEGLDESTROYIMAGEKHRPROC eglDestroyImageKHR = NULL;
 static PFNGLEGLIMAGETARGETTEXTURE2DOESPROC glEGLImageTargetTexture2DOES = NULL;
 #endif
 
+// EGL fence sync extension function pointers
+typedef EGLSyncKHR (*PFNEGLCREATESYNCKHRPROC)(EGLDisplay dpy, EGLenum type, const EGLint *attrib_list);
+typedef EGLBoolean (*PFNEGLDESTROYSYNCKHRPROC)(EGLDisplay dpy, EGLSyncKHR sync);
+typedef EGLint (*PFNEGLCLIENTWAITSYNCKHRPROC)(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
+typedef EGLint (*PFNEGLWAITSYNCKHRPROC)(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags);
+
+#ifndef eglCreateSyncKHR
+static PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR = NULL;
+#endif
+#ifndef eglDestroySyncKHR
+static PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = NULL;
+#endif
+#ifndef eglClientWaitSyncKHR
+static PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR = NULL;
+#endif
+#ifndef eglWaitSyncKHR
+static PFNEGLWAITSYNCKHRPROC eglWaitSyncKHR = NULL;
+#endif
+
+// Native fence (sync file) extension function pointer
+typedef EGLint (*PFNEGLDUPNATIVEFENCEFDANDROIDPROC)(EGLDisplay dpy, EGLSyncKHR sync);
+
+#ifndef eglDupNativeFenceFDANDROID
+static PFNEGLDUPNATIVEFENCEFDANDROIDPROC eglDupNativeFenceFDANDROID = NULL;
+#endif
+#ifndef EGL_SYNC_NATIVE_FENCE_ANDROID
+#define EGL_SYNC_NATIVE_FENCE_ANDROID 0x3144
+#endif
+#ifndef EGL_SYNC_NATIVE_FENCE_FD_ANDROID
+#define EGL_SYNC_NATIVE_FENCE_FD_ANDROID 0x3145
+#endif
+#ifndef EGL_NO_NATIVE_FENCE_FD_ANDROID
+#define EGL_NO_NATIVE_FENCE_FD_ANDROID -1
+#endif
+
+// dma-buf export extension function pointers
+typedef EGLBoolean (*PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC)(EGLDisplay dpy, EGLImageKHR image, int *fourcc, int *num_planes, EGLuint64KHR *modifiers);
+typedef EGLBoolean (*PFNEGLEXPORTDMABUFIMAGEMESAPROC)(EGLDisplay dpy, EGLImageKHR image, int *fds, EGLint *strides, EGLint *offsets);
+
+#ifndef eglExportDMABUFImageQueryMESA
+static PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC eglExportDMABUFImageQueryMESA = NULL;
+#endif
+#ifndef eglExportDMABUFImageMESA
+static PFNEGLEXPORTDMABUFIMAGEMESAPROC eglExportDMABUFImageMESA = NULL;
+#endif
+
 static void init_egl_image_extensions() {
   static gboolean initialized = FALSE;
   if (!initialized) {
     eglCreateImageKHR = (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
     eglDestroyImageKHR = (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress("eglDestroyImageKHR");
     glEGLImageTargetTexture2DOES = (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)eglGetProcAddress("glEGLImageTargetTexture2DOES");
+    eglCreateSyncKHR = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+    eglDestroySyncKHR = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+    eglClientWaitSyncKHR = (PFNEGLCLIENTWAITSYNCKHRPROC)eglGetProcAddress("eglClientWaitSyncKHR");
+    eglWaitSyncKHR = (PFNEGLWAITSYNCKHRPROC)eglGetProcAddress("eglWaitSyncKHR");
+    eglDupNativeFenceFDANDROID = (PFNEGLDUPNATIVEFENCEFDANDROIDPROC)eglGetProcAddress("eglDupNativeFenceFDANDROID");
+    eglExportDMABUFImageQueryMESA = (PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC)eglGetProcAddress("eglExportDMABUFImageQueryMESA");
+    eglExportDMABUFImageMESA = (PFNEGLEXPORTDMABUFIMAGEMESAPROC)eglGetProcAddress("eglExportDMABUFImageMESA");
     initialized = TRUE;
   }
 }
 
+// Synchronization between mpv's rendering & Flutter's sampling of a slot.
+typedef enum _TextureGLSyncMode {
+  // Fence created after rendering, waited on by Flutter's context on the GPU.
+  TEXTURE_GL_SYNC_MODE_WAIT_SYNC,
+  // Fence created after rendering, waited on by Flutter's raster thread.
+  TEXTURE_GL_SYNC_MODE_CLIENT_WAIT_SYNC,
+  // No fence support, render thread waits for rendering with |glFinish|.
+  TEXTURE_GL_SYNC_MODE_FINISH,
+} TextureGLSyncMode;
+
+static gboolean egl_has_extension(EGLDisplay egl_display,
+                                  const gchar* extension) {
+  const gchar* extensions = eglQueryString(egl_display, EGL_EXTENSIONS);
+  if (extensions == NULL) {
+    return FALSE;
+  }
+  // Match whole, space separated, extension names only.
+  gsize length = strlen(extension);
+  for (const gchar* match = strstr(extensions, extension); match != NULL;
+       match = strstr(match + length, extension)) {
+    if ((match == extensions || match[-1] == ' ') &&
+        (match[length] == ' ' || match[length] == '\0')) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+// Backing textures are allocated in multiples of this many pixels (in each
+// dimension) & the video frame is rendered into their top-left sub-viewport.
+// This avoids reallocating GPU memory for every change in video output size
+// e.g. while a window is being resized.
+#define TEXTURE_GL_BUCKET_SIZE 256
+
+// Number of slots in the FBO/EGLImage ring. At any time, one slot is held by
+// Flutter, one holds the newest finished frame & one is being rendered into.
+#define TEXTURE_GL_SLOT_COUNT 3
+
+// Maximum number of mirrors (see |texture_gl_new_mirror|) of a |TextureGL|.
+// Every mirror & the dma-buf consumer may hold a (different) slot, additional
+// slots are only allocated once actually needed.
+#define TEXTURE_GL_MAX_MIRRORS 4
+#define TEXTURE_GL_MAX_SLOT_COUNT \
+  (TEXTURE_GL_SLOT_COUNT + 1 + 1 + TEXTURE_GL_MAX_MIRRORS)
+
+// Render target formats, indexed by |VideoOutputFormat|. RGBA8 keeps the
+// unsized internal format for OpenGL ES 2.0 compatibility.
+typedef struct _TextureGLFormat {
+  const gchar* name;
+  GLint internal_format;
+  GLenum format;
+  GLenum type;
+  guint32 bytes_per_pixel;
+} TextureGLFormat;
+
+static const TextureGLFormat kTextureGLFormats[] = {
+    {"RGBA8", GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, 4},
+    {"RGB10_A2", GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, 4},
+    {"RGBA16F", GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8},
+};
+
+// Number of pixel buffer objects in the frame tap's read back ring. A read back
+// is mapped once its fence has signaled i.e. typically one or two frames later.
+#define TEXTURE_GL_READBACK_COUNT 3
+
+typedef struct _TextureGLReadback {
+  guint32 pbo;
+  gsize size;        // Allocated size of |pbo|
+  GLsync fence;      // Signaled once |glReadPixels| has completed
+  gint32 width;
+  gint32 height;
+  gdouble pts;
+} TextureGLReadback;
+
+typedef struct _TextureGLSlot {
+  guint32 fbo;            // mpv's FBO
+  guint32 mpv_texture;    // mpv's texture
+  EGLImageKHR egl_image;  // EGLImage for sharing between contexts
+  guint32 width;          // Dimensions of the rendered video frame
+  guint32 height;
+  guint32 texture_width;  // Dimensions of the backing texture (bucketed)
+  guint32 texture_height;
+  VideoOutputCrop crop;   // Region of the video rendered
+  guint32 generation;     // Incremented every time the slot is reallocated
+  gint64 target_time;     // mpv's target time of the rendered frame or 0
+  guint64 latency_frame;  // |FrameLatency| ID of the rendered frame or 0
+  EGLSyncKHR fence;       // Signaled once mpv's rendering has completed
+  gint dma_buf_fd;        // dma-buf exported from |egl_image| or -1
+  EGLint dma_buf_stride;
+  EGLint dma_buf_offset;
+  gint dma_buf_fourcc;
+  guint64 dma_buf_modifier;
+} TextureGLSlot;
+
 struct _TextureGL {
   FlTextureGL parent_instance;
-  guint32 name;              // Flutter's texture name
-  guint32 fbo;               // mpv's FBO
-  guint32 mpv_texture;       // mpv's texture
-  EGLImageKHR egl_image;     // EGLImage for sharing between contexts
+  guint32 name;                                 // Flutter's placeholder texture
+  guint32 names[TEXTURE_GL_MAX_SLOT_COUNT];     // Flutter's textures (per slot)
+  guint32 generations[TEXTURE_GL_MAX_SLOT_COUNT];  // Slot generation of |names|
+  TextureGLSlot slots[TEXTURE_GL_MAX_SLOT_COUNT];  // Only written on render thread
+  gint ready;                                   // Newest finished slot or -1
+  gint latest;                                  // Newest slot taken by Flutter
+  gint presented;                               // Slot held by Flutter or -1
+  TextureGL* source;                            // Mirrored |TextureGL| or NULL
+  GPtrArray* mirrors;                           // |TextureGL|s mirroring this
+  TextureGLSyncMode sync_mode;
+  GMutex mutex;                                 // Guards ring indices & counters
+  guint64 renders;                              // Performed renders
+  guint64 skipped_renders;                      // Renders skipped (no new frame)
   guint32 current_width;
   guint32 current_height;
+  guint32 current_texture_width;
+  guint32 current_texture_height;
+  VideoOutputCrop current_crop;
+  guint64 allocations;                          // Slot (re)allocations
+  VideoOutputFormat format;                     // Negotiated render format
+  gboolean format_negotiated;
+  guint64 texture_memory;                       // Bytes allocated by slots
+  guint64 tap_memory;                           // Bytes allocated by the tap
+  guint64 rendered_bytes;                       // Bytes written by renders
+  gint64 first_render_time;                     // Monotonic (microseconds)
+  MediaKitVideoDmaBufFrameCallback dma_buf_frame_callback;
+  gpointer dma_buf_frame_callback_context;
+  gboolean native_fence;                        // EGL_ANDROID_native_fence_sync
+  guint64 dma_buf_frames;                       // Frames delivered as dma-bufs
+  gint dma_buf_held;                            // Slot held by consumer or -1
+  guint64 dma_buf_held_id;                      // ID of the frame in it
+  guint64 dropped_dma_buf_frames;               // Not delivered while held
+  MediaKitVideoFrameTapCallback frame_tap_callback;
+  gpointer frame_tap_callback_context;
+  MediaKitVideoFrameTapConfiguration frame_tap_configuration;
+  // Frame tap resources. Only accessed on render thread.
+  guint32 tap_fbo;                              // Downscaled RGBA8 copy
+  guint32 tap_texture;
+  gint32 tap_width;
+  gint32 tap_height;
+  TextureGLReadback readbacks[TEXTURE_GL_READBACK_COUNT];
+  gint readback_index;                          // Next read back to issue
+  gint64 last_tap_time;
+  guint64 tapped_frames;                        // Frames delivered to the tap
+  guint64 dropped_taps;                         // Read backs skipped (GPU busy)
   VideoOutput* video_output;
 };
 
@@ -52,77 +239,925 @@ G_DEFINE_TYPE(TextureGL, texture_gl, fl_texture_gl_get_type())
 
 static void texture_gl_init(TextureGL* self) {
   self->name = 0;
-  self->fbo = 0;
-  self->mpv_texture = 0;
-  self->egl_image = EGL_NO_IMAGE_KHR;
+  for (gint i = 0; i < TEXTURE_GL_MAX_SLOT_COUNT; i++) {
+    self->names[i] = 0;
+    self->generations[i] = 0;
+    self->slots[i].fbo = 0;
+    self->slots[i].mpv_texture = 0;
+    self->slots[i].egl_image = EGL_NO_IMAGE_KHR;
+    self->slots[i].width = 0;
+    self->slots[i].height = 0;
+    self->slots[i].texture_width = 0;
+    self->slots[i].texture_height = 0;
+    self->slots[i].crop = VideoOutputCrop{0.0, 0.0, 1.0, 1.0};
+    self->slots[i].generation = 0;
+    self->slots[i].target_time = 0;
+    self->slots[i].latency_frame = 0;
+    self->slots[i].fence = EGL_NO_SYNC_KHR;
+    self->slots[i].dma_buf_fd = -1;
+    self->slots[i].dma_buf_stride = 0;
+    self->slots[i].dma_buf_offset = 0;
+    self->slots[i].dma_buf_fourcc = 0;
+    self->slots[i].dma_buf_modifier = 0;
+  }
+  self->ready = -1;
+  self->latest = -1;
+  self->presented = -1;
+  self->source = NULL;
+  self->mirrors = g_ptr_array_new();
+  self->sync_mode = TEXTURE_GL_SYNC_MODE_FINISH;
+  g_mutex_init(&self->mutex);
+  self->renders = 0;
+  self->skipped_renders = 0;
   self->current_width = 1;
   self->current_height = 1;
+  self->current_texture_width = 1;
+  self->current_texture_height = 1;
+  self->current_crop = VideoOutputCrop{0.0, 0.0, 1.0, 1.0};
+  self->allocations = 0;
+  self->format = VIDEO_OUTPUT_FORMAT_RGBA8;
+  self->format_negotiated = FALSE;
+  self->texture_memory = 0;
+  self->tap_memory = 0;
+  self->rendered_bytes = 0;
+  self->first_render_time = 0;
+  self->dma_buf_frame_callback = NULL;
+  self->dma_buf_frame_callback_context = NULL;
+  self->native_fence = FALSE;
+  self->dma_buf_frames = 0;
+  self->dma_buf_held = -1;
+  self->dma_buf_held_id = 0;
+  self->dropped_dma_buf_frames = 0;
+  self->frame_tap_callback = NULL;
+  self->frame_tap_callback_context = NULL;
+  self->frame_tap_configuration = MediaKitVideoFrameTapConfiguration{0, 0, 0.0};
+  self->tap_fbo = 0;
+  self->tap_texture = 0;
+  self->tap_width = 0;
+  self->tap_height = 0;
+  for (gint i = 0; i < TEXTURE_GL_READBACK_COUNT; i++) {
+    self->readbacks[i].pbo = 0;
+    self->readbacks[i].size = 0;
+    self->readbacks[i].fence = NULL;
+    self->readbacks[i].width = 0;
+    self->readbacks[i].height = 0;
+    self->readbacks[i].pts = -1.0;
+  }
+  self->readback_index = 0;
+  self->last_tap_time = 0;
+  self->tapped_frames = 0;
+  self->dropped_taps = 0;
   self->video_output = NULL;
 }
 
 static void texture_gl_dispose(GObject* object) {
   TextureGL* self = TEXTURE_GL(object);
-  VideoOutput* video_output = self->video_output;
-  
-  // Save current context
-  EGLDisplay current_display = eglGetCurrentDisplay();
-  EGLContext current_context = eglGetCurrentContext();
-  EGLSurface current_draw = eglGetCurrentSurface(EGL_DRAW);
-  EGLSurface current_read = eglGetCurrentSurface(EGL_READ);
-  
-  // Clean up Flutter's texture (in Flutter's context)
+  // Mirror: Slots & Flutter's textures are owned by |source|.
+  if (self->source != NULL) {
+    g_mutex_lock(&self->source->mutex);
+    g_ptr_array_remove(self->source->mirrors, self);
+    g_mutex_unlock(&self->source->mutex);
+    g_clear_object(&self->source);
+  }
+  // Clean up Flutter's textures (in Flutter's context). mpv's resources are
+  // released on the render thread through |texture_gl_release|.
   if (self->name != 0) {
     glDeleteTextures(1, &self->name);
     self->name = 0;
   }
-  
-  // Clean up EGLImage
-  if (self->egl_image != EGL_NO_IMAGE_KHR && video_output != NULL) {
-    EGLDisplay egl_display = video_output_get_egl_display(video_output);
-    eglDestroyImageKHR(egl_display, self->egl_image);
-    self->egl_image = EGL_NO_IMAGE_KHR;
-  }
-  
-  // Clean up mpv's OpenGL resources (in mpv's isolated context)
-  if (video_output != NULL) {
-    EGLDisplay egl_display = video_output_get_egl_display(video_output);
-    EGLContext egl_context = video_output_get_egl_context(video_output);
-    
-    if (egl_context != EGL_NO_CONTEXT) {
-      eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context);
-      
-      if (self->mpv_texture != 0) {
-        glDeleteTextures(1, &self->mpv_texture);
-        self->mpv_texture = 0;
-      }
-      if (self->fbo != 0) {
-        glDeleteFramebuffers(1, &self->fbo);
-        self->fbo = 0;
-      }
-      
-      // Restore previous context
-      eglMakeCurrent(current_display, current_draw, current_read, current_context);
+  for (gint i = 0; i < TEXTURE_GL_MAX_SLOT_COUNT; i++) {
+    if (self->names[i] != 0) {
+      glDeleteTextures(1, &self->names[i]);
+      self->names[i] = 0;
     }
   }
-  
   self->current_width = 1;
   self->current_height = 1;
   self->video_output = NULL;
   G_OBJECT_CLASS(texture_gl_parent_class)->dispose(object);
 }
 
+static void texture_gl_finalize(GObject* object) {
+  TextureGL* self = TEXTURE_GL(object);
+  g_ptr_array_unref(self->mirrors);
+  g_mutex_clear(&self->mutex);
+  G_OBJECT_CLASS(texture_gl_parent_class)->finalize(object);
+}
+
 static void texture_gl_class_init(TextureGLClass* klass) {
   FL_TEXTURE_GL_CLASS(klass)->populate = texture_gl_populate_texture;
   G_OBJECT_CLASS(klass)->dispose = texture_gl_dispose;
+  G_OBJECT_CLASS(klass)->finalize = texture_gl_finalize;
 }
 
 TextureGL* texture_gl_new(VideoOutput* video_output) {
+  TextureGL* self =
+      texture_gl_new_pooled(video_output_get_egl_display(video_output));
+  texture_gl_set_video_output(self, video_output);
+  return self;
+}
+
+TextureGL* texture_gl_new_pooled(EGLDisplay egl_display) {
   init_egl_image_extensions();
   TextureGL* self = TEXTURE_GL(g_object_new(texture_gl_get_type(), NULL));
+  if (egl_has_extension(egl_display, "EGL_KHR_fence_sync") &&
+      eglCreateSyncKHR != NULL && eglDestroySyncKHR != NULL &&
+      eglClientWaitSyncKHR != NULL) {
+    if (egl_has_extension(egl_display, "EGL_KHR_wait_sync") &&
+        eglWaitSyncKHR != NULL) {
+      self->sync_mode = TEXTURE_GL_SYNC_MODE_WAIT_SYNC;
+      g_print("media_kit: TextureGL: Using EGL_KHR_wait_sync fences.\n");
+    } else {
+      self->sync_mode = TEXTURE_GL_SYNC_MODE_CLIENT_WAIT_SYNC;
+      g_print("media_kit: TextureGL: Using EGL_KHR_fence_sync fences.\n");
+    }
+  } else {
+    self->sync_mode = TEXTURE_GL_SYNC_MODE_FINISH;
+    g_print("media_kit: TextureGL: EGL fences unavailable, using glFinish.\n");
+  }
+  // dma-buf frames are delivered along with a sync file.
+  self->native_fence =
+      self->sync_mode != TEXTURE_GL_SYNC_MODE_FINISH &&
+      egl_has_extension(egl_display, "EGL_ANDROID_native_fence_sync") &&
+      eglDupNativeFenceFDANDROID != NULL;
+  return self;
+}
+
+void texture_gl_set_video_output(TextureGL* self, VideoOutput* video_output) {
   self->video_output = video_output;
+}
+
+TextureGL* texture_gl_new_mirror(TextureGL* source) {
+  g_mutex_lock(&source->mutex);
+  if (source->mirrors->len >= TEXTURE_GL_MAX_MIRRORS) {
+    g_mutex_unlock(&source->mutex);
+    return NULL;
+  }
+  TextureGL* self = TEXTURE_GL(g_object_new(texture_gl_get_type(), NULL));
+  self->source = TEXTURE_GL(g_object_ref(source));
+  self->video_output = source->video_output;
+  self->sync_mode = source->sync_mode;
+  g_ptr_array_add(source->mirrors, self);
+  g_mutex_unlock(&source->mutex);
   return self;
 }
 
+void texture_gl_mark_frame_available(TextureGL* self,
+                                     FlTextureRegistrar* texture_registrar) {
+  fl_texture_registrar_mark_texture_frame_available(texture_registrar,
+                                                    FL_TEXTURE(self));
+  g_mutex_lock(&self->mutex);
+  for (guint i = 0; i < self->mirrors->len; i++) {
+    fl_texture_registrar_mark_texture_frame_available(
+        texture_registrar, FL_TEXTURE(g_ptr_array_index(self->mirrors, i)));
+  }
+  g_mutex_unlock(&self->mutex);
+}
+
+static void texture_gl_slot_free(TextureGLSlot* slot, EGLDisplay egl_display) {
+  if (slot->dma_buf_fd != -1) {
+    close(slot->dma_buf_fd);
+    slot->dma_buf_fd = -1;
+  }
+  if (slot->fence != EGL_NO_SYNC_KHR) {
+    eglDestroySyncKHR(egl_display, slot->fence);
+    slot->fence = EGL_NO_SYNC_KHR;
+  }
+  if (slot->egl_image != EGL_NO_IMAGE_KHR) {
+    eglDestroyImageKHR(egl_display, slot->egl_image);
+    slot->egl_image = EGL_NO_IMAGE_KHR;
+  }
+  if (slot->mpv_texture != 0) {
+    glDeleteTextures(1, &slot->mpv_texture);
+    slot->mpv_texture = 0;
+  }
+  if (slot->fbo != 0) {
+    glDeleteFramebuffers(1, &slot->fbo);
+    slot->fbo = 0;
+  }
+  slot->width = 0;
+  slot->height = 0;
+  slot->texture_width = 0;
+  slot->texture_height = 0;
+}
+
+static guint32 texture_gl_bucket(guint32 size) {
+  return (size + TEXTURE_GL_BUCKET_SIZE - 1) / TEXTURE_GL_BUCKET_SIZE *
+         TEXTURE_GL_BUCKET_SIZE;
+}
+
+// Whether the backing texture of |slot| can hold a |width| x |height| frame.
+static gboolean texture_gl_slot_fits(TextureGLSlot* slot,
+                                     guint32 width,
+                                     guint32 height) {
+  if (slot->fbo == 0) {
+    return FALSE;
+  }
+  // Grow as soon as the frame does not fit.
+  if (width > slot->texture_width || height > slot->texture_height) {
+    return FALSE;
+  }
+  // Shrink only once the frame is more than a bucket smaller (hysteresis).
+  if (slot->texture_width > texture_gl_bucket(width) + TEXTURE_GL_BUCKET_SIZE ||
+      slot->texture_height >
+          texture_gl_bucket(height) + TEXTURE_GL_BUCKET_SIZE) {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// Exports |slot|'s EGLImage as a dma-buf (once per allocation). Invoked on the
+// render thread.
+static gboolean texture_gl_slot_export_dma_buf(TextureGLSlot* slot,
+                                               EGLDisplay egl_display) {
+  if (slot->dma_buf_fd != -1) {
+    return TRUE;
+  }
+  gint fourcc = 0, planes = 0;
+  EGLuint64KHR modifier = 0;
+  if (!eglExportDMABUFImageQueryMESA(egl_display, slot->egl_image, &fourcc,
+                                     &planes, &modifier)) {
+    return FALSE;
+  }
+  // RGBA render targets are expected to be single plane.
+  if (planes != 1) {
+    return FALSE;
+  }
+  gint fd = -1;
+  EGLint stride = 0, offset = 0;
+  if (!eglExportDMABUFImageMESA(egl_display, slot->egl_image, &fd, &stride,
+                                &offset) ||
+      fd < 0) {
+    return FALSE;
+  }
+  slot->dma_buf_fd = fd;
+  slot->dma_buf_stride = stride;
+  slot->dma_buf_offset = offset;
+  slot->dma_buf_fourcc = fourcc;
+  slot->dma_buf_modifier = modifier;
+  return TRUE;
+}
+
+// Recomputes |texture_memory| & |tap_memory| from the slots & the frame tap,
+// accounting them to the video output. Flutter's textures are EGLImage
+// siblings of the slots' textures i.e. share their storage. Invoked on the
+// render thread.
+static void texture_gl_update_texture_memory(TextureGL* self) {
+  guint64 texture_memory = 0;
+  for (gint i = 0; i < TEXTURE_GL_MAX_SLOT_COUNT; i++) {
+    texture_memory += (guint64)self->slots[i].texture_width *
+                      self->slots[i].texture_height *
+                      kTextureGLFormats[self->format].bytes_per_pixel;
+  }
+  guint64 tap_memory = (guint64)self->tap_width * self->tap_height * 4;
+  for (gint i = 0; i < TEXTURE_GL_READBACK_COUNT; i++) {
+    tap_memory += self->readbacks[i].size;
+  }
+  g_mutex_lock(&self->mutex);
+  self->texture_memory = texture_memory;
+  self->tap_memory = tap_memory;
+  g_mutex_unlock(&self->mutex);
+  video_output_set_memory(self->video_output, texture_memory + tap_memory);
+}
+
+guint64 texture_gl_estimate_memory(VideoOutputFormat format,
+                                   gint64 width,
+                                   gint64 height) {
+  return (guint64)TEXTURE_GL_SLOT_COUNT * texture_gl_bucket((guint32)width) *
+         texture_gl_bucket((guint32)height) *
+         kTextureGLFormats[format].bytes_per_pixel;
+}
+
+// Releases the frame tap's FBO & read back ring. Invoked on the render thread.
+static void texture_gl_tap_free(TextureGL* self) {
+  for (gint i = 0; i < TEXTURE_GL_READBACK_COUNT; i++) {
+    TextureGLReadback* readback = &self->readbacks[i];
+    if (readback->fence != NULL) {
+      glDeleteSync(readback->fence);
+      readback->fence = NULL;
+    }
+    if (readback->pbo != 0) {
+      glDeleteBuffers(1, &readback->pbo);
+      readback->pbo = 0;
+    }
+    readback->size = 0;
+  }
+  if (self->tap_texture != 0) {
+    glDeleteTextures(1, &self->tap_texture);
+    self->tap_texture = 0;
+  }
+  if (self->tap_fbo != 0) {
+    glDeleteFramebuffers(1, &self->tap_fbo);
+    self->tap_fbo = 0;
+  }
+  self->tap_width = 0;
+  self->tap_height = 0;
+  self->readback_index = 0;
+}
+
+// Delivers finished read backs (oldest first) to |callback|, without waiting
+// for the ones still in-flight. Invoked on the render thread.
+static void texture_gl_tap_deliver(TextureGL* self,
+                                   MediaKitVideoFrameTapCallback callback,
+                                   gpointer context) {
+  for (gint i = 0; i < TEXTURE_GL_READBACK_COUNT; i++) {
+    TextureGLReadback* readback =
+        &self->readbacks[(self->readback_index + i) % TEXTURE_GL_READBACK_COUNT];
+    if (readback->fence == NULL) {
+      continue;
+    }
+    GLenum status = glClientWaitSync(readback->fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      // Later read backs cannot have completed either.
+      break;
+    }
+    glDeleteSync(readback->fence);
+    readback->fence = NULL;
+    gsize size = (gsize)readback->width * readback->height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+    const guint8* data = (const guint8*)glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (data != NULL) {
+      MediaKitVideoFrameTapFrame frame{
+          data, readback->width, readback->height, readback->width * 4,
+          readback->pts,
+      };
+      callback(&frame, context);
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      g_mutex_lock(&self->mutex);
+      self->tapped_frames++;
+      g_mutex_unlock(&self->mutex);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+}
+
+// Issues an asynchronous read back of |slot|'s (|width| x |height|) frame,
+// downscaled as per |configuration| & rate limited. Invoked on the render
+// thread right after mpv's rendering.
+static void texture_gl_tap(TextureGL* self,
+                           TextureGLSlot* slot,
+                           gint32 width,
+                           gint32 height) {
+  g_mutex_lock(&self->mutex);
+  MediaKitVideoFrameTapCallback callback = self->frame_tap_callback;
+  gpointer context = self->frame_tap_callback_context;
+  MediaKitVideoFrameTapConfiguration configuration =
+      self->frame_tap_configuration;
+  g_mutex_unlock(&self->mutex);
+  if (callback == NULL) {
+    if (self->tap_fbo != 0) {
+      texture_gl_tap_free(self);
+      texture_gl_update_texture_memory(self);
+    }
+    return;
+  }
+  if (epoxy_gl_version() < 30) {
+    g_printerr("media_kit: TextureGL: Frame tap requires OpenGL ES 3.0.\n");
+    g_mutex_lock(&self->mutex);
+    self->frame_tap_callback = NULL;
+    g_mutex_unlock(&self->mutex);
+    return;
+  }
+
+  texture_gl_tap_deliver(self, callback, context);
+
+  gint64 now = g_get_monotonic_time();
+  if (configuration.max_fps > 0.0 && self->last_tap_time != 0 &&
+      now - self->last_tap_time < G_USEC_PER_SEC / configuration.max_fps) {
+    return;
+  }
+  TextureGLReadback* readback = &self->readbacks[self->readback_index];
+  if (readback->fence != NULL) {
+    // GPU has not caught up with the ring, skip instead of stalling.
+    g_mutex_lock(&self->mutex);
+    self->dropped_taps++;
+    g_mutex_unlock(&self->mutex);
+    return;
+  }
+
+  // Downscale (maintaining aspect ratio) to fit the configured dimensions.
+  gdouble scale = 1.0;
+  if (configuration.max_width > 0) {
+    scale = MIN(scale, (gdouble)configuration.max_width / width);
+  }
+  if (configuration.max_height > 0) {
+    scale = MIN(scale, (gdouble)configuration.max_height / height);
+  }
+  gint32 tap_width = MAX((gint32)(width * scale + 0.5), 1);
+  gint32 tap_height = MAX((gint32)(height * scale + 0.5), 1);
+
+  // The frame is always copied into an RGBA8 texture, which also converts
+  // from the render format.
+  gboolean reallocated = FALSE;
+  if (self->tap_fbo == 0 || self->tap_width != tap_width ||
+      self->tap_height != tap_height) {
+    reallocated = TRUE;
+    if (self->tap_fbo == 0) {
+      glGenFramebuffers(1, &self->tap_fbo);
+      glGenTextures(1, &self->tap_texture);
+    }
+    glBindTexture(GL_TEXTURE_2D, self->tap_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, tap_width, tap_height, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, self->tap_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           self->tap_texture, 0);
+    self->tap_width = tap_width;
+    self->tap_height = tap_height;
+  }
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, slot->fbo);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, self->tap_fbo);
+  glBlitFramebuffer(0, 0, width, height, 0, 0, tap_width, tap_height,
+                    GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+  gsize size = (gsize)tap_width * tap_height * 4;
+  if (readback->pbo == 0) {
+    glGenBuffers(1, &readback->pbo);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+  if (readback->size != size) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    readback->size = size;
+    reallocated = TRUE;
+  }
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, self->tap_fbo);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glReadPixels(0, 0, tap_width, tap_height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  readback->width = tap_width;
+  readback->height = tap_height;
+  readback->pts = video_output_get_video_pts(self->video_output);
+  self->readback_index = (self->readback_index + 1) % TEXTURE_GL_READBACK_COUNT;
+  self->last_tap_time = now;
+  if (reallocated) {
+    texture_gl_update_texture_memory(self);
+  }
+}
+
+// Whether |format| is usable as a render target & can be shared with Flutter
+// through an EGLImage. Invoked on the render thread.
+static gboolean texture_gl_probe_format(VideoOutputFormat format,
+                                        EGLDisplay egl_display,
+                                        EGLContext egl_context) {
+  const TextureGLFormat* info = &kTextureGLFormats[format];
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  guint32 fbo = 0, texture = 0;
+  glGenFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, info->internal_format, 16, 16, 0,
+               info->format, info->type, NULL);
+  gboolean supported = glGetError() == GL_NO_ERROR;
+  if (supported) {
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           texture, 0);
+    supported = glCheckFramebufferStatus(GL_FRAMEBUFFER) ==
+                GL_FRAMEBUFFER_COMPLETE;
+  }
+  if (supported) {
+    EGLint egl_image_attribs[] = {EGL_NONE};
+    EGLImageKHR egl_image = eglCreateImageKHR(
+        egl_display, egl_context, EGL_GL_TEXTURE_2D_KHR,
+        (EGLClientBuffer)(guintptr)texture, egl_image_attribs);
+    supported = egl_image != EGL_NO_IMAGE_KHR;
+    if (supported) {
+      eglDestroyImageKHR(egl_display, egl_image);
+    }
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDeleteTextures(1, &texture);
+  glDeleteFramebuffers(1, &fbo);
+  return supported;
+}
+
+// Picks the requested render format or the next lower one supported by the
+// driver. RGBA8 is always assumed to be supported.
+static void texture_gl_negotiate_format(TextureGL* self,
+                                        EGLDisplay egl_display,
+                                        EGLContext egl_context) {
+  VideoOutputFormat requested =
+      video_output_get_configuration(self->video_output).format;
+  gint format = requested;
+  while (format > VIDEO_OUTPUT_FORMAT_RGBA8 &&
+         !texture_gl_probe_format((VideoOutputFormat)format, egl_display,
+                                  egl_context)) {
+    format--;
+  }
+  if (format != requested) {
+    g_printerr("media_kit: TextureGL: %s render format unsupported, using %s.\n",
+               kTextureGLFormats[requested].name,
+               kTextureGLFormats[format].name);
+  } else if (format != VIDEO_OUTPUT_FORMAT_RGBA8) {
+    g_print("media_kit: TextureGL: Using %s render format.\n",
+            kTextureGLFormats[format].name);
+  }
+  g_mutex_lock(&self->mutex);
+  self->format = (VideoOutputFormat)format;
+  self->format_negotiated = TRUE;
+  g_mutex_unlock(&self->mutex);
+}
+
+static void texture_gl_slot_allocate(TextureGLSlot* slot,
+                                     const TextureGLFormat* format,
+                                     EGLDisplay egl_display,
+                                     EGLContext egl_context,
+                                     guint32 width,
+                                     guint32 height) {
+  texture_gl_slot_free(slot, egl_display);
+
+  guint32 texture_width = texture_gl_bucket(width);
+  guint32 texture_height = texture_gl_bucket(height);
+
+  // Create mpv's FBO and texture
+  glGenFramebuffers(1, &slot->fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, slot->fbo);
+
+  glGenTextures(1, &slot->mpv_texture);
+  glBindTexture(GL_TEXTURE_2D, slot->mpv_texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, format->internal_format, texture_width,
+               texture_height, 0, format->format, format->type, NULL);
+
+  // Attach mpv's texture to FBO
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         slot->mpv_texture, 0);
+
+  // Area outside the sub-viewport is never rendered to, clear it once.
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+
+  // Create EGLImage from mpv's texture
+  EGLint egl_image_attribs[] = {EGL_NONE};
+  slot->egl_image = eglCreateImageKHR(
+      egl_display, egl_context, EGL_GL_TEXTURE_2D_KHR,
+      (EGLClientBuffer)(guintptr)slot->mpv_texture, egl_image_attribs);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  slot->texture_width = texture_width;
+  slot->texture_height = texture_height;
+  slot->generation++;
+}
+
+// Whether slot at |index| holds the newest finished frame or is held by
+// Flutter or the dma-buf consumer. |mutex| must be locked.
+static gboolean texture_gl_slot_busy(TextureGL* self, gint index) {
+  if (index == self->ready || index == self->latest ||
+      index == self->presented || index == self->dma_buf_held) {
+    return TRUE;
+  }
+  for (guint i = 0; i < self->mirrors->len; i++) {
+    if (index == TEXTURE_GL(g_ptr_array_index(self->mirrors, i))->presented) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+gboolean texture_gl_render(TextureGL* self,
+                           gboolean frame,
+                           gint64 target_time) {
+  VideoOutput* video_output = self->video_output;
+
+  gint32 required_width = (guint32)video_output_get_width(video_output);
+  gint32 required_height = (guint32)video_output_get_height(video_output);
+  if (required_width <= 0 || required_height <= 0) {
+    return FALSE;
+  }
+  VideoOutputCrop required_crop = video_output_get_crop(video_output);
+
+  g_mutex_lock(&self->mutex);
+  // Reuse the last rendered frame if mpv has nothing new to show & it is
+  // already of the required dimensions & crop.
+  if (!frame) {
+    gint last = self->ready != -1 ? self->ready : self->latest;
+    if (last != -1 && self->slots[last].width == required_width &&
+        self->slots[last].height == required_height &&
+        video_output_crop_equal(self->slots[last].crop, required_crop)) {
+      self->skipped_renders++;
+      g_mutex_unlock(&self->mutex);
+      return FALSE;
+    }
+  }
+  // Pick a slot which neither holds the newest finished frame nor is held by
+  // Flutter (through this texture or its mirrors) or the dma-buf consumer. The
+  // ring is sized such that one is always available.
+  gint index = 0;
+  while (texture_gl_slot_busy(self, index)) {
+    index++;
+  }
+  g_mutex_unlock(&self->mutex);
+
+  EGLDisplay egl_display = video_output_get_egl_display(video_output);
+  EGLContext egl_context = video_output_get_egl_context(video_output);
+  mpv_render_context* render_context =
+      video_output_get_render_context(video_output);
+
+  TextureGLSlot* slot = &self->slots[index];
+  // Fence of a frame which was superseded before Flutter took it.
+  if (slot->fence != EGL_NO_SYNC_KHR) {
+    eglDestroySyncKHR(egl_display, slot->fence);
+    slot->fence = EGL_NO_SYNC_KHR;
+  }
+  if (!self->format_negotiated) {
+    texture_gl_negotiate_format(self, egl_display, egl_context);
+  }
+  if (!texture_gl_slot_fits(slot, required_width, required_height)) {
+    texture_gl_slot_allocate(slot, &kTextureGLFormats[self->format],
+                             egl_display, egl_context, required_width,
+                             required_height);
+    g_mutex_lock(&self->mutex);
+    self->allocations++;
+    g_mutex_unlock(&self->mutex);
+    texture_gl_update_texture_memory(self);
+  }
+  slot->width = required_width;
+  slot->height = required_height;
+  slot->crop = required_crop;
+  slot->target_time = target_time;
+  FrameLatency* frame_latency = video_output_get_frame_latency(video_output);
+  slot->latency_frame = frame_latency_get_current(frame_latency);
+
+  // Bind mpv's FBO
+  glBindFramebuffer(GL_FRAMEBUFFER, slot->fbo);
+
+  // Render mpv frame to the top-left sub-viewport of mpv's texture
+  // Let mpv know about higher bit depth targets (affects e.g. dithering).
+  gint32 internal_format = self->format == VIDEO_OUTPUT_FORMAT_RGBA8
+                               ? 0
+                               : kTextureGLFormats[self->format].internal_format;
+  mpv_opengl_fbo fbo{(gint32)slot->fbo, required_width, required_height,
+                     internal_format};
+  int flip_y = 0;
+  // With frame pacing, the render is already timed by the caller. On a shared
+  // render thread, blocking would stall every other video output rendered
+  // after this one in the same pass.
+  VideoOutputConfiguration configuration =
+      video_output_get_configuration(video_output);
+  int block_for_target_time =
+      !configuration.frame_pacing && !configuration.shared_render_thread;
+  mpv_render_param params[] = {
+      {MPV_RENDER_PARAM_OPENGL_FBO, &fbo},
+      {MPV_RENDER_PARAM_FLIP_Y, &flip_y},
+      {MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &block_for_target_time},
+      {MPV_RENDER_PARAM_INVALID, NULL},
+  };
+  mpv_render_context_render(render_context, params);
+  frame_latency_record(frame_latency, FRAME_LATENCY_STAGE_RENDERED);
+
+  // Unbind FBO
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  texture_gl_tap(self, slot, required_width, required_height);
+
+  // The dma-buf consumer holds at most one frame: Newer frames are dropped
+  // (for it) until that one is released.
+  g_mutex_lock(&self->mutex);
+  MediaKitVideoDmaBufFrameCallback dma_buf_frame_callback =
+      self->dma_buf_frame_callback;
+  gpointer dma_buf_frame_callback_context =
+      self->dma_buf_frame_callback_context;
+  if (dma_buf_frame_callback != NULL && self->dma_buf_held != -1) {
+    dma_buf_frame_callback = NULL;
+    self->dropped_dma_buf_frames++;
+  }
+  g_mutex_unlock(&self->mutex);
+  // The dma-buf consumer waits on a sync file (signaled once rendering has
+  // completed) instead of the render thread.
+  EGLSyncKHR native_fence = EGL_NO_SYNC_KHR;
+  if (dma_buf_frame_callback != NULL && self->native_fence) {
+    EGLint attributes[] = {EGL_SYNC_NATIVE_FENCE_FD_ANDROID,
+                           EGL_NO_NATIVE_FENCE_FD_ANDROID, EGL_NONE};
+    native_fence = eglCreateSyncKHR(egl_display, EGL_SYNC_NATIVE_FENCE_ANDROID,
+                                    attributes);
+  }
+
+  if (self->sync_mode != TEXTURE_GL_SYNC_MODE_FINISH) {
+    // Flutter waits on the fence before sampling the slot. Flush is required
+    // for the fence to ever signal.
+    slot->fence = eglCreateSyncKHR(egl_display, EGL_SYNC_FENCE_KHR, NULL);
+    glFlush();
+  }
+  if (slot->fence == EGL_NO_SYNC_KHR) {
+    glFinish();
+  }
+  frame_latency_record(frame_latency, FRAME_LATENCY_STAGE_FLUSHED);
+
+  // Deliver the frame to the dma-buf consumer. Done before publishing the
+  // slot: Flutter's raster thread destroys its fence once it takes the slot.
+  gint fence_fd = -1;
+  if (native_fence != EGL_NO_SYNC_KHR) {
+    // The sync file is created by the flush above.
+    fence_fd = eglDupNativeFenceFDANDROID(egl_display, native_fence);
+    eglDestroySyncKHR(egl_display, native_fence);
+  }
+  if (dma_buf_frame_callback != NULL &&
+      texture_gl_slot_export_dma_buf(slot, egl_display)) {
+    if (fence_fd < 0 && slot->fence != EGL_NO_SYNC_KHR) {
+      // No sync file: Rendering must have completed upon delivery.
+      fence_fd = -1;
+      eglClientWaitSyncKHR(egl_display, slot->fence, 0, EGL_FOREVER_KHR);
+    }
+    g_mutex_lock(&self->mutex);
+    self->dma_buf_held = index;
+    self->dma_buf_held_id = ++self->dma_buf_frames;
+    guint64 id = self->dma_buf_held_id;
+    g_mutex_unlock(&self->mutex);
+    MediaKitVideoDmaBufFrame dma_buf_frame{
+        slot->dma_buf_fd,
+        required_width,
+        required_height,
+        slot->dma_buf_stride,
+        slot->dma_buf_offset,
+        (guint32)slot->dma_buf_fourcc,
+        slot->dma_buf_modifier,
+        video_output_get_video_pts(video_output),
+        id,
+        fence_fd,
+    };
+    dma_buf_frame_callback(&dma_buf_frame, dma_buf_frame_callback_context);
+  } else if (fence_fd >= 0) {
+    close(fence_fd);
+  }
+
+  // Publish the slot as the newest finished frame.
+  g_mutex_lock(&self->mutex);
+  self->ready = index;
+  self->renders++;
+  self->rendered_bytes += (guint64)required_width * required_height *
+                          kTextureGLFormats[self->format].bytes_per_pixel;
+  if (self->first_render_time == 0) {
+    self->first_render_time = g_get_monotonic_time();
+  }
+  g_mutex_unlock(&self->mutex);
+  return TRUE;
+}
+
+gboolean texture_gl_has_consumers(TextureGL* self) {
+  g_mutex_lock(&self->mutex);
+  gboolean consumers = self->mirrors->len > 0 ||
+                       self->dma_buf_frame_callback != NULL ||
+                       self->frame_tap_callback != NULL;
+  g_mutex_unlock(&self->mutex);
+  return consumers;
+}
+
+gboolean texture_gl_get_frame(TextureGL* self,
+                              guint32* fbo,
+                              guint32* width,
+                              guint32* height,
+                              guint64* serial) {
+  g_mutex_lock(&self->mutex);
+  gint index = self->ready != -1 ? self->ready : self->latest;
+  *serial = self->renders;
+  g_mutex_unlock(&self->mutex);
+  if (index == -1) {
+    return FALSE;
+  }
+  // Slots are only reallocated on the render thread i.e. not concurrently.
+  *fbo = self->slots[index].fbo;
+  *width = self->slots[index].width;
+  *height = self->slots[index].height;
+  return *fbo != 0;
+}
+
+void texture_gl_release(TextureGL* self) {
+  EGLDisplay egl_display = video_output_get_egl_display(self->video_output);
+  g_mutex_lock(&self->mutex);
+  self->ready = -1;
+  self->latest = -1;
+  self->presented = -1;
+  self->dma_buf_held = -1;
+  for (guint i = 0; i < self->mirrors->len; i++) {
+    TEXTURE_GL(g_ptr_array_index(self->mirrors, i))->presented = -1;
+  }
+  g_mutex_unlock(&self->mutex);
+  for (gint i = 0; i < TEXTURE_GL_MAX_SLOT_COUNT; i++) {
+    texture_gl_slot_free(&self->slots[i], egl_display);
+  }
+  texture_gl_tap_free(self);
+  texture_gl_update_texture_memory(self);
+}
+
+void texture_gl_get_statistics(TextureGL* self, FlValue* statistics) {
+  g_mutex_lock(&self->mutex);
+  fl_value_set_string_take(statistics, "renders",
+                           fl_value_new_int(self->renders));
+  fl_value_set_string_take(statistics, "skippedRenders",
+                           fl_value_new_int(self->skipped_renders));
+  fl_value_set_string_take(statistics, "textureAllocations",
+                           fl_value_new_int(self->allocations));
+  const gchar* sync_mode = "glFinish";
+  if (self->sync_mode == TEXTURE_GL_SYNC_MODE_WAIT_SYNC) {
+    sync_mode = "EGL_KHR_wait_sync";
+  } else if (self->sync_mode == TEXTURE_GL_SYNC_MODE_CLIENT_WAIT_SYNC) {
+    sync_mode = "EGL_KHR_fence_sync";
+  }
+  fl_value_set_string_take(statistics, "syncMode",
+                           fl_value_new_string(sync_mode));
+  fl_value_set_string_take(statistics, "mirrors",
+                           fl_value_new_int(self->mirrors->len));
+  fl_value_set_string_take(statistics, "dmaBufFrames",
+                           fl_value_new_int(self->dma_buf_frames));
+  fl_value_set_string_take(statistics, "droppedDmaBufFrames",
+                           fl_value_new_int(self->dropped_dma_buf_frames));
+  fl_value_set_string_take(statistics, "dmaBufSyncFile",
+                           fl_value_new_bool(self->native_fence));
+  fl_value_set_string_take(statistics, "tappedFrames",
+                           fl_value_new_int(self->tapped_frames));
+  fl_value_set_string_take(statistics, "droppedTaps",
+                           fl_value_new_int(self->dropped_taps));
+  const TextureGLFormat* format = &kTextureGLFormats[self->format];
+  fl_value_set_string_take(statistics, "renderFormat",
+                           fl_value_new_string(format->name));
+  fl_value_set_string_take(statistics, "bytesPerPixel",
+                           fl_value_new_int(format->bytes_per_pixel));
+  // Memory held by the slots' backing textures & bytes written per rendered
+  // frame / per second (on average).
+  fl_value_set_string_take(statistics, "textureMemory",
+                           fl_value_new_int(self->texture_memory));
+  fl_value_set_string_take(statistics, "tapMemory",
+                           fl_value_new_int(self->tap_memory));
+  fl_value_set_string_take(
+      statistics, "frameBytes",
+      fl_value_new_int((gint64)self->current_width * self->current_height *
+                       format->bytes_per_pixel));
+  gint64 elapsed = self->first_render_time == 0
+                       ? 0
+                       : g_get_monotonic_time() - self->first_render_time;
+  fl_value_set_string_take(
+      statistics, "renderBandwidth",
+      fl_value_new_int(elapsed > 0 ? (gint64)(self->rendered_bytes *
+                                              (gdouble)G_USEC_PER_SEC /
+                                              elapsed)
+                                   : 0));
+  g_mutex_unlock(&self->mutex);
+}
+
+// Takes the newest finished slot (if any) for |self| or one of its mirrors,
+// whose held slot is |presented|. The previously held slot is handed back to
+// the render thread. Invoked on Flutter's raster thread.
+static gint texture_gl_acquire(TextureGL* self, gint* presented) {
+  g_mutex_lock(&self->mutex);
+  if (self->ready != -1) {
+    self->latest = self->ready;
+    self->ready = -1;
+  }
+  if (self->latest != -1) {
+    *presented = self->latest;
+  }
+  gint index = *presented;
+  g_mutex_unlock(&self->mutex);
+
+  if (index == -1) {
+    return -1;
+  }
+  TextureGLSlot* slot = &self->slots[index];
+  // Wait for mpv's rendering into the slot to complete. Only needed once,
+  // when Flutter takes the slot.
+  if (slot->fence != EGL_NO_SYNC_KHR) {
+    EGLDisplay egl_display = video_output_get_egl_display(self->video_output);
+    if (self->sync_mode == TEXTURE_GL_SYNC_MODE_WAIT_SYNC) {
+      eglWaitSyncKHR(egl_display, slot->fence, 0);
+    } else {
+      eglClientWaitSyncKHR(egl_display, slot->fence,
+                           EGL_SYNC_FLUSH_COMMANDS_BIT_KHR, EGL_FOREVER_KHR);
+    }
+    eglDestroySyncKHR(egl_display, slot->fence);
+    slot->fence = EGL_NO_SYNC_KHR;
+  }
+  // Create Flutter's texture from EGLImage, if the slot was (re)allocated
+  // since it was last held by Flutter. Shared with the mirrors.
+  if (self->names[index] == 0 ||
+      self->generations[index] != slot->generation) {
+    if (self->names[index] != 0) {
+      glDeleteTextures(1, &self->names[index]);
+    }
+    glGenTextures(1, &self->names[index]);
+    glBindTexture(GL_TEXTURE_2D, self->names[index]);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, slot->egl_image);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    self->generations[index] = slot->generation;
+  }
+  return index;
+}
+
 gboolean texture_gl_populate_texture(FlTextureGL* texture,
                                      guint32* target,
                                      guint32* name,
@@ -131,147 +1166,135 @@ gboolean texture_gl_populate_texture(FlTextureGL* texture,
                                      GError** error) {
   TextureGL* self = TEXTURE_GL(texture);
   VideoOutput* video_output = self->video_output;
-  
-  gint32 required_width = (guint32)video_output_get_width(video_output);
-  gint32 required_height = (guint32)video_output_get_height(video_output);
-  
-  if (required_width > 0 && required_height > 0) {
-    gboolean first_frame = self->name == 0 || self->fbo == 0 || self->mpv_texture == 0;
-    gboolean resize = self->current_width != required_width ||
-                      self->current_height != required_height;
-    
-    if (first_frame || resize) {
-      // Save Flutter's current EGL context
-      EGLDisplay flutter_display = eglGetCurrentDisplay();
-      EGLContext flutter_context = eglGetCurrentContext();
-      EGLSurface flutter_draw = eglGetCurrentSurface(EGL_DRAW);
-      EGLSurface flutter_read = eglGetCurrentSurface(EGL_READ);
-      
-      EGLDisplay egl_display = video_output_get_egl_display(video_output);
-      EGLContext egl_context = video_output_get_egl_context(video_output);
-      
-      // Switch to mpv's isolated context to create/resize mpv's texture and FBO
-      eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context);
-      
-      // Free previous resources in mpv's context
-      if (!first_frame) {
-        glDeleteTextures(1, &self->mpv_texture);
-        glDeleteFramebuffers(1, &self->fbo);
-        if (self->egl_image != EGL_NO_IMAGE_KHR) {
-          eglDestroyImageKHR(egl_display, self->egl_image);
-        }
-      }
-      
-      // Create mpv's FBO and texture
-      glGenFramebuffers(1, &self->fbo);
-      glBindFramebuffer(GL_FRAMEBUFFER, self->fbo);
-      
-      glGenTextures(1, &self->mpv_texture);
-      glBindTexture(GL_TEXTURE_2D, self->mpv_texture);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, required_width, required_height,
-                   0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-      
-      // Attach mpv's texture to FBO
-      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                             GL_TEXTURE_2D, self->mpv_texture, 0);
-      
-      // Create EGLImage from mpv's texture
-      EGLint egl_image_attribs[] = { EGL_NONE };
-      self->egl_image = eglCreateImageKHR(
-          egl_display,
-          egl_context,
-          EGL_GL_TEXTURE_2D_KHR,
-          (EGLClientBuffer)(guintptr)self->mpv_texture,
-          egl_image_attribs);
-      
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
-      glBindTexture(GL_TEXTURE_2D, 0);
-      
-      // Flush to ensure mpv's texture is ready
-      glFlush();
-      
-      // Switch back to Flutter's context to create/update Flutter's texture
-      eglMakeCurrent(flutter_display, flutter_draw, flutter_read, flutter_context);
-      
-      // Free previous Flutter texture
-      if (!first_frame && self->name != 0) {
-        glDeleteTextures(1, &self->name);
+
+  // Mirror: Sample the frame rendered by |source|.
+  if (self->source != NULL) {
+    gint index = texture_gl_acquire(self->source, &self->presented);
+    if (index != -1) {
+      TextureGLSlot* slot = &self->source->slots[index];
+      *target = GL_TEXTURE_2D;
+      *name = self->source->names[index];
+      *width = slot->texture_width;
+      *height = slot->texture_height;
+      return TRUE;
+    }
+  } else {
+    gint previous = self->presented;
+    gint index = texture_gl_acquire(self, &self->presented);
+    if (index != -1 && index != previous) {
+      // A slot held by Flutter is never rendered into i.e. a different slot
+      // means a new frame.
+      video_output_notify_present(video_output, self->slots[index].target_time);
+      frame_latency_record_frame(video_output_get_frame_latency(video_output),
+                                 self->slots[index].latency_frame,
+                                 FRAME_LATENCY_STAGE_POPULATED);
+    }
+    if (index != -1) {
+      TextureGLSlot* slot = &self->slots[index];
+      if (self->current_width != slot->width ||
+          self->current_height != slot->height ||
+          self->current_texture_width != slot->texture_width ||
+          self->current_texture_height != slot->texture_height ||
+          !video_output_crop_equal(self->current_crop, slot->crop)) {
+        self->current_width = slot->width;
+        self->current_height = slot->height;
+        self->current_texture_width = slot->texture_width;
+        self->current_texture_height = slot->texture_height;
+        self->current_crop = slot->crop;
+        // Notify Flutter about dimension change
+        video_output_notify_texture_update(
+            video_output, self->current_width, self->current_height,
+            self->current_texture_width, self->current_texture_height,
+            self->current_crop);
       }
-      
-      // Create Flutter's texture from EGLImage
-      glGenTextures(1, &self->name);
-      glBindTexture(GL_TEXTURE_2D, self->name);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-      glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, self->egl_image);
-      glBindTexture(GL_TEXTURE_2D, 0);
-      
-      self->current_width = required_width;
-      self->current_height = required_height;
-      
-      // Notify Flutter about dimension change
-      video_output_notify_texture_update(video_output);
-      
-      // Flutter's context is already current, so we're ready to render
+
+      *target = GL_TEXTURE_2D;
+      *name = self->names[index];
+      *width = self->current_texture_width;
+      *height = self->current_texture_height;
+      return TRUE;
     }
-    
-    // Save Flutter's current context
-    EGLDisplay flutter_display = eglGetCurrentDisplay();
-    EGLContext flutter_context = eglGetCurrentContext();
-    EGLSurface flutter_draw = eglGetCurrentSurface(EGL_DRAW);
-    EGLSurface flutter_read = eglGetCurrentSurface(EGL_READ);
-    
-    EGLDisplay egl_display = video_output_get_egl_display(video_output);
-    EGLContext egl_context = video_output_get_egl_context(video_output);
-    mpv_render_context* render_context = video_output_get_render_context(video_output);
-    
-    // Switch to mpv's isolated context for rendering
-    eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context);
-    
-    // Bind mpv's FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, self->fbo);
-    
-    // Render mpv frame to mpv's texture
-    mpv_opengl_fbo fbo{(gint32)self->fbo, required_width, required_height, 0};
-    int flip_y = 0;
-    mpv_render_param params[] = {
-        {MPV_RENDER_PARAM_OPENGL_FBO, &fbo},
-        {MPV_RENDER_PARAM_FLIP_Y, &flip_y},
-        {MPV_RENDER_PARAM_INVALID, NULL},
-    };
-    mpv_render_context_render(render_context, params);
-    
-    // Unbind FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    
-    // Flush to ensure rendering is complete
-    glFlush();
-    
-    // Restore Flutter's context
-    eglMakeCurrent(flutter_display, flutter_draw, flutter_read, flutter_context);
   }
-  
-  *target = GL_TEXTURE_2D;
-  *name = self->name;
-  *width = self->current_width;
-  *height = self->current_height;
-  
+
+  // First frame not yet available - create dummy texture in Flutter's context
   if (self->name == 0) {
-    // First frame not yet available - create dummy texture in Flutter's context
     glGenTextures(1, &self->name);
     glBindTexture(GL_TEXTURE_2D, self->name);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 NULL);
     glBindTexture(GL_TEXTURE_2D, 0);
-    *name = self->name;
-    *width = 1;
-    *height = 1;
   }
-  
+  *target = GL_TEXTURE_2D;
+  *name = self->name;
+  *width = 1;
+  *height = 1;
+  return TRUE;
+}
+
+// Invoked on the render thread. Nothing to do: Reaching it means that the
+// render (& callback delivery) in-flight before was completed.
+static void texture_gl_flush_callbacks(gpointer data) {}
+
+// Blocks until callbacks copied out by an in-flight render have returned.
+static void texture_gl_wait_for_callbacks(TextureGL* self) {
+  RenderThread* render_thread =
+      video_output_get_render_thread(self->video_output);
+  if (render_thread != NULL) {
+    render_thread_invoke(render_thread, texture_gl_flush_callbacks, NULL);
+  }
+}
+
+gboolean texture_gl_set_dma_buf_frame_callback(
+    TextureGL* self,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context) {
+  EGLDisplay egl_display = video_output_get_egl_display(self->video_output);
+  if (!egl_has_extension(egl_display, "EGL_MESA_image_dma_buf_export") ||
+      eglExportDMABUFImageQueryMESA == NULL ||
+      eglExportDMABUFImageMESA == NULL) {
+    return FALSE;
+  }
+  g_mutex_lock(&self->mutex);
+  self->dma_buf_frame_callback = callback;
+  self->dma_buf_frame_callback_context = context;
+  g_mutex_unlock(&self->mutex);
+  texture_gl_wait_for_callbacks(self);
+  if (callback == NULL) {
+    // The previous consumer's frame is released.
+    g_mutex_lock(&self->mutex);
+    self->dma_buf_held = -1;
+    g_mutex_unlock(&self->mutex);
+  }
+  return TRUE;
+}
+
+gboolean texture_gl_release_dma_buf_frame(TextureGL* self, guint64 id) {
+  g_mutex_lock(&self->mutex);
+  gboolean released = self->dma_buf_held != -1 && self->dma_buf_held_id == id;
+  if (released) {
+    self->dma_buf_held = -1;
+  }
+  g_mutex_unlock(&self->mutex);
+  return released;
+}
+
+gboolean texture_gl_set_frame_tap_callback(
+    TextureGL* self,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context) {
+  // Floating point render targets cannot be blitted into the RGBA8 copy.
+  if (video_output_get_configuration(self->video_output).format ==
+      VIDEO_OUTPUT_FORMAT_RGBA16F) {
+    return FALSE;
+  }
+  g_mutex_lock(&self->mutex);
+  self->frame_tap_callback = callback;
+  self->frame_tap_callback_context = context;
+  self->frame_tap_configuration =
+      configuration != NULL ? *configuration
+                            : MediaKitVideoFrameTapConfiguration{0, 0, 0.0};
+  g_mutex_unlock(&self->mutex);
+  texture_gl_wait_for_callbacks(self);
   return TRUE;
-}
\ No newline at end of file
+}
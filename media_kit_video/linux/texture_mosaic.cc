@@ -0,0 +1,530 @@
+// This file is a part of media_kit
+// (https://github.com/media-kit/media-kit).
+//
+// Copyright © 2021 & onwards, Hitesh Kumar Saini <saini123hitesh@gmail.com>.
+// All rights reserved.
+// Use of this source code is governed by MIT license that can be found in the
+// LICENSE file.
+
+#include "include/media_kit_video/texture_mosaic.h"
+
+#include <epoxy/gl.h>
+#include <epoxy/egl.h>
+
+// EGLImage & fence sync extension function pointers
+typedef EGLImageKHR (*PFNEGLCREATEIMAGEKHRPROC)(EGLDisplay dpy, EGLContext ctx, EGLenum target, EGLClientBuffer buffer, const EGLint *attrib_list);
+typedef EGLBoolean (*PFNEGLDESTROYIMAGEKHRPROC)(EGLDisplay dpy, EGLImageKHR image);
+typedef void (*PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)(GLenum target, GLeglImageOES image);
+typedef EGLSyncKHR (*PFNEGLCREATESYNCKHRPROC)(EGLDisplay dpy, EGLenum type, const EGLint *attrib_list);
+typedef EGLBoolean (*PFNEGLDESTROYSYNCKHRPROC)(EGLDisplay dpy, EGLSyncKHR sync);
+typedef EGLint (*PFNEGLCLIENTWAITSYNCKHRPROC)(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout);
+
+#ifndef eglCreateImageKHR
+static PFNEGLCREATEIMAGEKHRPROC eglCreateImageKHR = NULL;
+#endif
+#ifndef eglDestroyImageKHR
+static PFNEGLDESTROYIMAGEKHRPROC eglDestroyImageKHR = NULL;
+#endif
+#ifndef glEGLImageTargetTexture2DOES
+static PFNGLEGLIMAGETARGETTEXTURE2DOESPROC glEGLImageTargetTexture2DOES = NULL;
+#endif
+#ifndef eglCreateSyncKHR
+static PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR = NULL;
+#endif
+#ifndef eglDestroySyncKHR
+static PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = NULL;
+#endif
+#ifndef eglClientWaitSyncKHR
+static PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR = NULL;
+#endif
+
+static void init_egl_image_extensions() {
+  static gboolean initialized = FALSE;
+  if (!initialized) {
+    eglCreateImageKHR = (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
+    eglDestroyImageKHR = (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress("eglDestroyImageKHR");
+    glEGLImageTargetTexture2DOES = (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)eglGetProcAddress("glEGLImageTargetTexture2DOES");
+    eglCreateSyncKHR = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+    eglDestroySyncKHR = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+    eglClientWaitSyncKHR = (PFNEGLCLIENTWAITSYNCKHRPROC)eglGetProcAddress("eglClientWaitSyncKHR");
+    initialized = TRUE;
+  }
+}
+
+// Number of slots in the composed FBO/EGLImage ring. At any time, one slot is
+// held by Flutter, one holds the newest composed frame & one is being composed.
+#define TEXTURE_MOSAIC_SLOT_COUNT 3
+
+typedef struct _TextureMosaicTile {
+  VideoOutput* video_output;
+  TextureMosaicRect rect;
+} TextureMosaicTile;
+
+typedef struct _TextureMosaicSlot {
+  guint32 fbo;
+  guint32 texture;
+  EGLImageKHR egl_image;
+  EGLSyncKHR fence;     // Signaled once composition has completed
+  guint64 layout;       // Layout the slot was last composed with
+  // Frame serial of every tile last copied into the slot. Slots lag behind the
+  // newest frame differently, hence tracked per slot.
+  guint64 serials[TEXTURE_MOSAIC_MAX_TILES];
+} TextureMosaicSlot;
+
+struct _TextureMosaic {
+  FlTextureGL parent_instance;
+  guint32 name;                                   // Flutter's placeholder texture
+  guint32 names[TEXTURE_MOSAIC_SLOT_COUNT];       // Flutter's textures (per slot)
+  TextureMosaicSlot slots[TEXTURE_MOSAIC_SLOT_COUNT];  // Only written on render thread
+  gint ready;                                     // Newest composed slot or -1
+  gint presented;                                 // Slot held by Flutter or -1
+  GMutex mutex;                                   // Guards ring indices & counters
+  gint32 width;
+  gint32 height;
+  RenderThread* render_thread;                    // Render thread of the tiles
+  EGLDisplay egl_display;
+  GArray* tiles;                                  // Only accessed on render thread
+  guint64 layout;                                 // Incremented on layout changes
+  gboolean supported;                             // OpenGL ES 3.0 (blit) available
+  guint64 compositions;                           // Composed frames
+  guint64 tile_copies;                            // Tile frames copied
+  FlTextureRegistrar* texture_registrar;
+};
+
+G_DEFINE_TYPE(TextureMosaic, texture_mosaic, fl_texture_gl_get_type())
+
+static void texture_mosaic_init(TextureMosaic* self) {
+  self->name = 0;
+  for (gint i = 0; i < TEXTURE_MOSAIC_SLOT_COUNT; i++) {
+    self->names[i] = 0;
+    self->slots[i].fbo = 0;
+    self->slots[i].texture = 0;
+    self->slots[i].egl_image = EGL_NO_IMAGE_KHR;
+    self->slots[i].fence = EGL_NO_SYNC_KHR;
+    self->slots[i].layout = 0;
+    memset(self->slots[i].serials, 0, sizeof(self->slots[i].serials));
+  }
+  self->ready = -1;
+  self->presented = -1;
+  g_mutex_init(&self->mutex);
+  self->width = 1;
+  self->height = 1;
+  self->render_thread = NULL;
+  self->egl_display = EGL_NO_DISPLAY;
+  self->tiles = g_array_new(FALSE, FALSE, sizeof(TextureMosaicTile));
+  self->layout = 1;
+  self->supported = TRUE;
+  self->compositions = 0;
+  self->tile_copies = 0;
+  self->texture_registrar = NULL;
+}
+
+static void texture_mosaic_request_compose(gpointer data);
+
+// Invoked on the render thread.
+static void texture_mosaic_release(gpointer data) {
+  TextureMosaic* self = TEXTURE_MOSAIC(data);
+  render_thread_cancel(self->render_thread, self);
+  for (guint i = 0; i < self->tiles->len; i++) {
+    video_output_remove_frame_callback(
+        g_array_index(self->tiles, TextureMosaicTile, i).video_output,
+        texture_mosaic_request_compose, self);
+  }
+  g_array_set_size(self->tiles, 0);
+  for (gint i = 0; i < TEXTURE_MOSAIC_SLOT_COUNT; i++) {
+    TextureMosaicSlot* slot = &self->slots[i];
+    if (slot->fence != EGL_NO_SYNC_KHR) {
+      eglDestroySyncKHR(self->egl_display, slot->fence);
+      slot->fence = EGL_NO_SYNC_KHR;
+    }
+    if (slot->egl_image != EGL_NO_IMAGE_KHR) {
+      eglDestroyImageKHR(self->egl_display, slot->egl_image);
+      slot->egl_image = EGL_NO_IMAGE_KHR;
+    }
+    if (slot->texture != 0) {
+      glDeleteTextures(1, &slot->texture);
+      slot->texture = 0;
+    }
+    if (slot->fbo != 0) {
+      glDeleteFramebuffers(1, &slot->fbo);
+      slot->fbo = 0;
+    }
+  }
+}
+
+static void texture_mosaic_dispose(GObject* object) {
+  TextureMosaic* self = TEXTURE_MOSAIC(object);
+  if (self->render_thread != NULL) {
+    render_thread_invoke(self->render_thread, texture_mosaic_release, self);
+    g_clear_object(&self->render_thread);
+  }
+  // Clean up Flutter's textures (in Flutter's context).
+  if (self->name != 0) {
+    glDeleteTextures(1, &self->name);
+    self->name = 0;
+  }
+  for (gint i = 0; i < TEXTURE_MOSAIC_SLOT_COUNT; i++) {
+    if (self->names[i] != 0) {
+      glDeleteTextures(1, &self->names[i]);
+      self->names[i] = 0;
+    }
+  }
+  G_OBJECT_CLASS(texture_mosaic_parent_class)->dispose(object);
+}
+
+static void texture_mosaic_finalize(GObject* object) {
+  TextureMosaic* self = TEXTURE_MOSAIC(object);
+  g_array_unref(self->tiles);
+  g_mutex_clear(&self->mutex);
+  G_OBJECT_CLASS(texture_mosaic_parent_class)->finalize(object);
+}
+
+static void texture_mosaic_class_init(TextureMosaicClass* klass) {
+  FL_TEXTURE_GL_CLASS(klass)->populate = texture_mosaic_populate_texture;
+  G_OBJECT_CLASS(klass)->dispose = texture_mosaic_dispose;
+  G_OBJECT_CLASS(klass)->finalize = texture_mosaic_finalize;
+}
+
+TextureMosaic* texture_mosaic_new(FlTextureRegistrar* texture_registrar,
+                                  gint32 width,
+                                  gint32 height) {
+  init_egl_image_extensions();
+  TextureMosaic* self =
+      TEXTURE_MOSAIC(g_object_new(texture_mosaic_get_type(), NULL));
+  self->texture_registrar = texture_registrar;
+  self->width = MAX(width, 1);
+  self->height = MAX(height, 1);
+  return self;
+}
+
+static void texture_mosaic_slot_allocate(TextureMosaic* self,
+                                         TextureMosaicSlot* slot) {
+  glGenFramebuffers(1, &slot->fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, slot->fbo);
+  glGenTextures(1, &slot->texture);
+  glBindTexture(GL_TEXTURE_2D, slot->texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->width, self->height, 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         slot->texture, 0);
+  EGLint egl_image_attribs[] = {EGL_NONE};
+  slot->egl_image = eglCreateImageKHR(
+      self->egl_display, render_thread_get_egl_context(self->render_thread),
+      EGL_GL_TEXTURE_2D_KHR, (EGLClientBuffer)(guintptr)slot->texture,
+      egl_image_attribs);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  // Forces a full composition.
+  slot->layout = 0;
+}
+
+// Composes the newest frames of the tiles into a free slot. Only tiles which
+// rendered a new frame since the slot was last composed are copied. Invoked on
+// the render thread.
+static void texture_mosaic_compose(gpointer data) {
+  TextureMosaic* self = TEXTURE_MOSAIC(data);
+  if (!self->supported) {
+    return;
+  }
+  if (epoxy_gl_version() < 30) {
+    g_printerr("media_kit: TextureMosaic: OpenGL ES 3.0 is required.\n");
+    self->supported = FALSE;
+    return;
+  }
+
+  g_mutex_lock(&self->mutex);
+  gint index = 0;
+  while (index == self->ready || index == self->presented) {
+    index++;
+  }
+  g_mutex_unlock(&self->mutex);
+
+  TextureMosaicSlot* slot = &self->slots[index];
+  // Fence of a composition which was superseded before Flutter took it.
+  if (slot->fence != EGL_NO_SYNC_KHR) {
+    eglDestroySyncKHR(self->egl_display, slot->fence);
+    slot->fence = EGL_NO_SYNC_KHR;
+  }
+  if (slot->fbo == 0) {
+    texture_mosaic_slot_allocate(self, slot);
+  }
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, slot->fbo);
+  glViewport(0, 0, self->width, self->height);
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  if (slot->layout != self->layout) {
+    glDisable(GL_SCISSOR_TEST);
+    glClear(GL_COLOR_BUFFER_BIT);
+    memset(slot->serials, 0, sizeof(slot->serials));
+    slot->layout = self->layout;
+  }
+  guint copies = 0;
+  for (guint i = 0; i < self->tiles->len; i++) {
+    TextureMosaicTile* tile = &g_array_index(self->tiles, TextureMosaicTile, i);
+    guint32 fbo = 0, width = 0, height = 0;
+    guint64 serial = 0;
+    if (!video_output_get_frame(tile->video_output, &fbo, &width, &height,
+                                &serial) ||
+        serial == slot->serials[i]) {
+      continue;
+    }
+    // Fit the frame inside the tile, maintaining aspect ratio.
+    TextureMosaicRect* rect = &tile->rect;
+    gdouble scale = MIN((gdouble)rect->width / width,
+                        (gdouble)rect->height / height);
+    gint32 w = (gint32)(width * scale + 0.5);
+    gint32 h = (gint32)(height * scale + 0.5);
+    gint32 x = rect->left + (rect->width - w) / 2;
+    gint32 y = rect->top + (rect->height - h) / 2;
+    // Clear the letterbox (previous frame may have had another aspect ratio).
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(rect->left, rect->top, rect->width, rect->height);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBlitFramebuffer(0, 0, width, height, x, y, x + w, y + h,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    slot->serials[i] = serial;
+    copies++;
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  if (eglCreateSyncKHR != NULL && eglClientWaitSyncKHR != NULL) {
+    slot->fence = eglCreateSyncKHR(self->egl_display, EGL_SYNC_FENCE_KHR, NULL);
+    glFlush();
+  }
+  if (slot->fence == EGL_NO_SYNC_KHR) {
+    glFinish();
+  }
+
+  g_mutex_lock(&self->mutex);
+  self->ready = index;
+  self->compositions++;
+  self->tile_copies += copies;
+  g_mutex_unlock(&self->mutex);
+  fl_texture_registrar_mark_texture_frame_available(self->texture_registrar,
+                                                    FL_TEXTURE(self));
+}
+
+// Invoked on the render thread, whenever a tile rendered a new frame.
+static void texture_mosaic_request_compose(gpointer data) {
+  TextureMosaic* self = TEXTURE_MOSAIC(data);
+  // Coalesced i.e. tiles rendering in the same pass cause a single composition.
+  render_thread_request_render(self->render_thread, texture_mosaic_compose,
+                               self);
+}
+
+typedef struct _TextureMosaicLayoutData {
+  TextureMosaic* self;
+  GArray* tiles;
+} TextureMosaicLayoutData;
+
+// Invoked on the render thread.
+static void texture_mosaic_apply_layout(gpointer data) {
+  TextureMosaicLayoutData* layout_data = (TextureMosaicLayoutData*)data;
+  TextureMosaic* self = layout_data->self;
+  for (guint i = 0; i < self->tiles->len; i++) {
+    video_output_remove_frame_callback(
+        g_array_index(self->tiles, TextureMosaicTile, i).video_output,
+        texture_mosaic_request_compose, self);
+  }
+  g_array_set_size(self->tiles, 0);
+  g_array_append_vals(self->tiles, layout_data->tiles->data,
+                      layout_data->tiles->len);
+  for (guint i = 0; i < self->tiles->len; i++) {
+    video_output_add_frame_callback(
+        g_array_index(self->tiles, TextureMosaicTile, i).video_output,
+        texture_mosaic_request_compose, self);
+  }
+  self->layout++;
+  texture_mosaic_request_compose(self);
+}
+
+guint texture_mosaic_set_layout(TextureMosaic* self,
+                                VideoOutput** video_outputs,
+                                const TextureMosaicRect* rects,
+                                guint count,
+                                gboolean* rejected) {
+  guint rejected_count = 0;
+  for (guint i = 0; i < count; i++) {
+    rejected[i] = FALSE;
+  }
+  // The render thread of the first (H/W rendered) tile is adopted.
+  for (guint i = 0; i < count && self->render_thread == NULL; i++) {
+    RenderThread* render_thread = video_output_get_render_thread(video_outputs[i]);
+    if (render_thread != NULL) {
+      self->render_thread = RENDER_THREAD(g_object_ref(render_thread));
+      self->egl_display = render_thread_get_egl_display(render_thread);
+    }
+  }
+  if (self->render_thread == NULL) {
+    if (count > 0) {
+      g_printerr("media_kit: TextureMosaic: No H/W rendered tiles.\n");
+    }
+    for (guint i = 0; i < count; i++) {
+      rejected[i] = TRUE;
+    }
+    return count;
+  }
+  GArray* tiles = g_array_new(FALSE, FALSE, sizeof(TextureMosaicTile));
+  for (guint i = 0; i < count; i++) {
+    if (video_output_get_render_thread(video_outputs[i]) !=
+            self->render_thread ||
+        tiles->len == TEXTURE_MOSAIC_MAX_TILES) {
+      rejected[i] = TRUE;
+      rejected_count++;
+      continue;
+    }
+    // Floating point render targets cannot be blitted into the RGBA8 mosaic.
+    if (video_output_get_configuration(video_outputs[i]).format ==
+        VIDEO_OUTPUT_FORMAT_RGBA16F) {
+      rejected[i] = TRUE;
+      rejected_count++;
+      continue;
+    }
+    // Clip to the mosaic.
+    TextureMosaicRect rect = rects[i];
+    gint32 right = MIN(rect.left + rect.width, self->width);
+    gint32 bottom = MIN(rect.top + rect.height, self->height);
+    rect.left = CLAMP(rect.left, 0, self->width);
+    rect.top = CLAMP(rect.top, 0, self->height);
+    rect.width = right - rect.left;
+    rect.height = bottom - rect.top;
+    if (rect.width <= 0 || rect.height <= 0) {
+      continue;
+    }
+    TextureMosaicTile tile{video_outputs[i], rect};
+    g_array_append_val(tiles, tile);
+  }
+  TextureMosaicLayoutData layout_data{self, tiles};
+  render_thread_invoke(self->render_thread, texture_mosaic_apply_layout,
+                       &layout_data);
+  g_array_unref(tiles);
+  return rejected_count;
+}
+
+typedef struct _TextureMosaicRemoveData {
+  TextureMosaic* self;
+  VideoOutput* video_output;
+} TextureMosaicRemoveData;
+
+// Invoked on the render thread.
+static void texture_mosaic_remove(gpointer data) {
+  TextureMosaicRemoveData* remove_data = (TextureMosaicRemoveData*)data;
+  TextureMosaic* self = remove_data->self;
+  gboolean removed = FALSE;
+  for (guint i = 0; i < self->tiles->len;) {
+    if (g_array_index(self->tiles, TextureMosaicTile, i).video_output ==
+        remove_data->video_output) {
+      g_array_remove_index(self->tiles, i);
+      removed = TRUE;
+    } else {
+      i++;
+    }
+  }
+  if (removed) {
+    video_output_remove_frame_callback(remove_data->video_output,
+                                       texture_mosaic_request_compose, self);
+    self->layout++;
+    texture_mosaic_request_compose(self);
+  }
+}
+
+void texture_mosaic_remove_video_output(TextureMosaic* self,
+                                        VideoOutput* video_output) {
+  if (self->render_thread == NULL) {
+    return;
+  }
+  TextureMosaicRemoveData remove_data{self, video_output};
+  render_thread_invoke(self->render_thread, texture_mosaic_remove,
+                       &remove_data);
+}
+
+guint64 texture_mosaic_get_memory(TextureMosaic* self) {
+  guint64 memory = 0;
+  g_mutex_lock(&self->mutex);
+  for (gint i = 0; i < TEXTURE_MOSAIC_SLOT_COUNT; i++) {
+    if (self->slots[i].texture != 0) {
+      memory += (guint64)self->width * self->height * 4;
+    }
+  }
+  g_mutex_unlock(&self->mutex);
+  return memory;
+}
+
+void texture_mosaic_get_statistics(TextureMosaic* self, FlValue* statistics) {
+  fl_value_set_string_take(statistics, "textureMemory",
+                           fl_value_new_int(texture_mosaic_get_memory(self)));
+  g_mutex_lock(&self->mutex);
+  fl_value_set_string_take(statistics, "width", fl_value_new_int(self->width));
+  fl_value_set_string_take(statistics, "height",
+                           fl_value_new_int(self->height));
+  fl_value_set_string_take(statistics, "compositions",
+                           fl_value_new_int(self->compositions));
+  fl_value_set_string_take(statistics, "tileCopies",
+                           fl_value_new_int(self->tile_copies));
+  g_mutex_unlock(&self->mutex);
+}
+
+gboolean texture_mosaic_populate_texture(FlTextureGL* texture,
+                                         guint32* target,
+                                         guint32* name,
+                                         guint32* width,
+                                         guint32* height,
+                                         GError** error) {
+  TextureMosaic* self = TEXTURE_MOSAIC(texture);
+
+  // Take the newest composed slot (if any), handing the previously held one
+  // back to the render thread.
+  g_mutex_lock(&self->mutex);
+  if (self->ready != -1) {
+    self->presented = self->ready;
+    self->ready = -1;
+  }
+  gint index = self->presented;
+  g_mutex_unlock(&self->mutex);
+
+  if (index != -1) {
+    TextureMosaicSlot* slot = &self->slots[index];
+    if (slot->fence != EGL_NO_SYNC_KHR) {
+      eglClientWaitSyncKHR(self->egl_display, slot->fence,
+                           EGL_SYNC_FLUSH_COMMANDS_BIT_KHR, EGL_FOREVER_KHR);
+      eglDestroySyncKHR(self->egl_display, slot->fence);
+      slot->fence = EGL_NO_SYNC_KHR;
+    }
+    // Slots are allocated once & never reallocated.
+    if (self->names[index] == 0) {
+      glGenTextures(1, &self->names[index]);
+      glBindTexture(GL_TEXTURE_2D, self->names[index]);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, slot->egl_image);
+      glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    *target = GL_TEXTURE_2D;
+    *name = self->names[index];
+    *width = self->width;
+    *height = self->height;
+    return TRUE;
+  }
+
+  // Nothing composed yet - create dummy texture in Flutter's context
+  if (self->name == 0) {
+    glGenTextures(1, &self->name);
+    glBindTexture(GL_TEXTURE_2D, self->name);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+  *target = GL_TEXTURE_2D;
+  *name = self->name;
+  *width = 1;
+  *height = 1;
+  return TRUE;
+}
@@ -12,6 +12,7 @@ struct _TextureSW {
   FlPixelBufferTexture parent_instance;
   guint32 current_width;
   guint32 current_height;
+  VideoOutputCrop current_crop;
   VideoOutput* video_output;
 };
 
@@ -20,6 +21,7 @@ G_DEFINE_TYPE(TextureSW, texture_sw, fl_pixel_buffer_texture_get_type())
 static void texture_sw_init(TextureSW* self) {
   self->current_width = 1;
   self->current_height = 1;
+  self->current_crop = VideoOutputCrop{0.0, 0.0, 1.0, 1.0};
   self->video_output = NULL;
 }
 
@@ -43,22 +45,37 @@ gboolean texture_sw_copy_pixels(FlPixelBufferTexture* texture,
                                 guint32* width,
                                 guint32* height,
                                 GError** error) {
+  // Shown until the first frame is rendered.
+  static const guint8 kTextureSWBlackPixel[4] = {0, 0, 0, 255};
   TextureSW* self = TEXTURE_SW(texture);
   VideoOutput* video_output = self->video_output;
-  gint32 required_width = (guint32)video_output_get_width(video_output);
-  gint32 required_height = (guint32)video_output_get_height(video_output);
-  if (required_width > 0 && required_height > 0) {
-    guint8* pixel_buffer = video_output_get_pixel_buffer(video_output);
-    if (self->current_width != required_width ||
-        self->current_height != required_height) {
-      self->current_width = required_width;
-      self->current_height = required_height;
-      // Notify Flutter about the change in texture's dimensions.
-      video_output_notify_texture_update(video_output);
-    }
-    *buffer = pixel_buffer;
-    *width = required_width;
-    *height = required_height;
+  const guint8* pixel_buffer = NULL;
+  gint64 frame_width = 0, frame_height = 0;
+  VideoOutputCrop crop;
+  if (!video_output_acquire_pixel_buffer(video_output, &pixel_buffer,
+                                         &frame_width, &frame_height, &crop)) {
+    *buffer = kTextureSWBlackPixel;
+    *width = 1;
+    *height = 1;
+    return TRUE;
   }
+  // Dimensions of the frame itself, which may lag behind a resize.
+  if (self->current_width != frame_width ||
+      self->current_height != frame_height ||
+      !video_output_crop_equal(self->current_crop, crop)) {
+    self->current_width = frame_width;
+    self->current_height = frame_height;
+    self->current_crop = crop;
+    // Notify Flutter about the change in texture's dimensions.
+    video_output_notify_texture_update(video_output, frame_width, frame_height,
+                                       frame_width, frame_height, crop);
+  }
+  video_output_notify_present(video_output, 0);
+  // Only the first copy of a frame is recorded.
+  frame_latency_record(video_output_get_frame_latency(video_output),
+                       FRAME_LATENCY_STAGE_POPULATED);
+  *buffer = pixel_buffer;
+  *width = frame_width;
+  *height = frame_height;
   return TRUE;
 }
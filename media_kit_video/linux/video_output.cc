@@ -7,27 +7,136 @@
 // LICENSE file.
 
 #include "include/media_kit_video/video_output.h"
+#include "include/media_kit_video/pixel_buffer_pool.h"
+#include "include/media_kit_video/render_thread.h"
 #include "include/media_kit_video/texture_gl.h"
 #include "include/media_kit_video/texture_sw.h"
 
+#include <math.h>
+
+#include <atomic>
+
 #include <epoxy/egl.h>
 #include <epoxy/glx.h>
 #include <gdk/gdkwayland.h>
 #include <gdk/gdkx.h>
 
+
+// Dynamic resolution scale factors, stepped through when the render budget is
+// exceeded (see |video_output_update_scale|).
+static const gdouble kVideoOutputScales[] = {1.0, 0.75, 0.5, 0.375, 0.25};
+#define VIDEO_OUTPUT_SCALE_COUNT \
+  ((gint)(sizeof(kVideoOutputScales) / sizeof(kVideoOutputScales[0])))
+// Number of rendered frames to wait after a scale change before stepping
+// down/up again. Stepping up requires sustained headroom.
+#define VIDEO_OUTPUT_SCALE_DOWN_FRAMES 30
+#define VIDEO_OUTPUT_SCALE_UP_FRAMES 120
+// Stepping up is only done if the estimated render time at the higher scale
+// stays below this fraction of the budget.
+#define VIDEO_OUTPUT_SCALE_UP_HEADROOM 0.75
+
+static const VideoOutputCrop kVideoOutputNoCrop = {0.0, 0.0, 1.0, 1.0};
+
+// |reply_userdata| of the properties set by |video_output_apply_crop|.
+#define VIDEO_OUTPUT_CROP_REPLY 1
+
+// |pixel_buffer_state| packs the indices (+1 i.e. 0 if none) of the newest
+// complete pixel buffer (low byte) & of the one held by Flutter (next byte),
+// so that both are read & updated together.
+#define VIDEO_OUTPUT_PIXEL_BUFFER_LATEST(state) (((state)&0xFF) - 1)
+#define VIDEO_OUTPUT_PIXEL_BUFFER_PRESENTED(state) ((((state) >> 8) & 0xFF) - 1)
+#define VIDEO_OUTPUT_PIXEL_BUFFER_STATE(latest, presented) \
+  (((latest) + 1) | (((presented) + 1) << 8))
+
+// Bytes held by all |VideoOutput|s in the process (see |video_output_set_memory|).
+static GMutex video_output_memory_mutex;
+static guint64 video_output_memory = 0;
+static guint64 video_output_memory_high_water_mark = 0;
+
+// A pixel buffer is reacquired from the pool once its capacity exceeds this
+// many times the one required e.g. after the video output was shrunk.
+#define VIDEO_OUTPUT_PIXEL_BUFFER_SHRINK_FACTOR 4
+
+// S/W rendered frame.
+typedef struct _VideoOutputPixelBuffer {
+  guint8* data; /* From |pixel_buffer_pool_acquire| or NULL. */
+  gsize capacity;
+  gint64 width;
+  gint64 height;
+  VideoOutputCrop crop;
+} VideoOutputPixelBuffer;
+
 struct _VideoOutput {
   GObject parent_instance;
   TextureGL* texture_gl;
+  GPtrArray* mirrors; /* |TextureGL|s mirroring |texture_gl|. */
+  GArray* frame_callbacks; /* |VideoOutputFrameCallback|s (render thread). */
   EGLDisplay egl_display; /* EGL display for mpv rendering (shared with flutter). */
-  EGLContext egl_context; /* Isolated EGL context (non-shared). */
+  RenderThread* render_thread; /* Owns the isolated EGL context (non-shared). */
   EGLSurface egl_surface; /* Place holder surface for activating egl context */
-  guint8* pixel_buffer;
+  VideoOutputPixelBuffer pixel_buffers[SW_RENDERING_PIXEL_BUFFER_COUNT];
+  gint pixel_buffer_state; /* Atomic, see |VIDEO_OUTPUT_PIXEL_BUFFER_STATE|. */
   TextureSW* texture_sw;
-  GMutex mutex; /* Only used in S/W rendering. */
+  RenderThread* sw_render_thread; /* Renders S/W frames (no EGL context). */
+  GMutex sw_mark_mutex;
+  guint sw_mark_source; /* Idle marking the S/W frame available or 0. */
+  guint64 main_thread_frames; /* Frames marked available on the main thread. */
+  gint64 main_thread_time; /* Total time spent (microseconds). */
   mpv_handle* handle;
+  mpv_handle* observer; /* Weak client observing "video-out-params". */
+  gint observer_pending; /* Set from mpv's wakeup callback (atomic). */
+  GMutex dimensions_mutex;
+  gint64 video_width;  /* Cached "video-out-params" (rotation applied). */
+  gint64 video_height;
   mpv_render_context* render_context;
   gint64 width;
   gint64 height;
+  gint64 display_width;  /* Size at which the video output is displayed. */
+  gint64 display_height;
+  // Crop state, guarded by |dimensions_mutex|.
+  VideoOutputCrop crop; /* Requested through |video_output_set_crop|. */
+  VideoOutputCrop applied_crop; /* Rendered i.e. mpv's properties are set. */
+  VideoOutputCrop pending_crop; /* Awaiting |crop_replies|. */
+  gint crop_replies; /* Outstanding replies for |pending_crop| (atomic). */
+  gint cropped; /* |pending_crop| is not |kVideoOutputNoCrop| (atomic). */
+  gboolean crop_stale; /* The player changed its own zoom or pan. */
+  gdouble user_zoom; /* Player's own "video-zoom" & "video-pan-x/y". */
+  gdouble user_pan_x;
+  gdouble user_pan_y;
+  gdouble crop_zoom; /* Last values set, combining the above & the crop. */
+  gdouble crop_pan_x;
+  gdouble crop_pan_y;
+  gint scale_index; /* Index in |kVideoOutputScales| (atomic). */
+  // Statistics written by the render thread & read on the platform thread.
+  std::atomic<gdouble> render_time; /* Moving average in microseconds. */
+  guint scale_frames;  /* Rendered frames since last scale change. */
+  std::atomic<guint64> scale_changes;
+  gint visible; /* Atomic. Hidden video outputs do not render new frames. */
+  gboolean stale; /* Frames were skipped while hidden (render thread). */
+  std::atomic<guint64> suspended_frames; /* Frames skipped while hidden. */
+  gint64 refresh_interval; /* Of the display (microseconds). */
+  gboolean pending_frame; /* New frame deferred by frame pacing. */
+  std::atomic<guint64> deferred_renders;
+  gint64 next_tick; /* Frame rate cap: Monotonic time of the next tick. */
+  gint64 last_due_time; /* Monotonic time at which the last frame was due. */
+  gdouble frame_duration; /* Moving average of the source's frame duration. */
+  gboolean capped_frame; /* Current frame was skipped by the frame rate cap. */
+  std::atomic<guint64> capped_frames;
+  std::atomic<gint64> fps_window_start; /* Achieved frame rate. */
+  guint fps_window_frames;
+  std::atomic<gdouble> fps;
+  GMutex pacing_mutex; /* Guards presentation counters (raster thread). */
+  gint64 last_present_time; /* mpv's time of the last presentation. */
+  gint64 last_target_time; /* mpv's target time of the last presented frame. */
+  guint64 presented_frames;
+  guint64 late_frames;
+  guint64 judder_frames;
+  FrameLatency* frame_latency; /* NULL unless measuring frame latency. */
+  guint64 memory; /* Accounted in |video_output_memory|. */
+  gboolean prewarmed; /* Adopted |VideoOutputPrewarmed| resources. */
+  gint64 create_time; /* Time taken by |video_output_new| (microseconds). */
+  gint64 created_at; /* Monotonic time at which |video_output_new| returned. */
+  gint64 first_frame_time; /* From |created_at| to the first frame or 0. */
   VideoOutputConfiguration configuration;
   TextureUpdateCallback texture_update_callback;
   gpointer texture_update_callback_context;
@@ -35,8 +144,650 @@ struct _VideoOutput {
   gboolean destroyed;
 };
 
+typedef struct _VideoOutputFrameCallback {
+  RenderThreadCallback callback;
+  gpointer context;
+} VideoOutputFrameCallback;
+
 G_DEFINE_TYPE(VideoOutput, video_output, G_TYPE_OBJECT)
 
+static void video_output_render(gpointer data);
+
+#ifdef MPV_RENDER_API_TYPE_SW
+static void video_output_render_sw(gpointer data);
+#endif
+
+// Re-renders the current frame (e.g. at new dimensions), even if paused.
+static void video_output_request_render(VideoOutput* self) {
+  // H/W
+  if (self->texture_gl) {
+    render_thread_request_render(self->render_thread, video_output_render,
+                                 self);
+  }
+#ifdef MPV_RENDER_API_TYPE_SW
+  // S/W
+  if (self->texture_sw && self->sw_render_thread != NULL) {
+    render_thread_request_render(self->sw_render_thread,
+                                 video_output_render_sw, self);
+  }
+#endif
+}
+
+// Invoked by mpv on an arbitrary thread. No mpv API may be called from here,
+// pending events are drained lazily in |video_output_drain_observer|.
+static void video_output_observer_wakeup(void* data) {
+  VideoOutput* self = (VideoOutput*)data;
+  g_atomic_int_set(&self->observer_pending, TRUE);
+  // Complete a pending crop or re-apply it with the player's new zoom or pan.
+  if (g_atomic_int_get(&self->crop_replies) > 0 ||
+      g_atomic_int_get(&self->cropped)) {
+    video_output_request_render(self);
+  }
+}
+
+// Reads the (rotation applied) video dimensions from "video-out-params".
+static void video_output_parse_video_out_params(const mpv_node* params,
+                                                gint64* width,
+                                                gint64* height) {
+  int64_t dw = 0, dh = 0, rotate = 0;
+  if (params->format == MPV_FORMAT_NODE_MAP) {
+    for (int32_t i = 0; i < params->u.list->num; i++) {
+      char* key = params->u.list->keys[i];
+      auto value = params->u.list->values[i];
+      if (value.format == MPV_FORMAT_INT64) {
+        if (strcmp(key, "dw") == 0) {
+          dw = value.u.int64;
+        }
+        if (strcmp(key, "dh") == 0) {
+          dh = value.u.int64;
+        }
+        if (strcmp(key, "rotate") == 0) {
+          rotate = value.u.int64;
+        }
+      }
+    }
+  }
+  *width = rotate == 0 || rotate == 180 ? dw : dh;
+  *height = rotate == 0 || rotate == 180 ? dh : dw;
+}
+
+// Tracks the player's own "video-zoom", "video-pan-x" or "video-pan-y" i.e.
+// changes to a value other than the one last set by |video_output_apply_crop|.
+static void video_output_observe_crop_property(
+    VideoOutput* self,
+    const mpv_event_property* property,
+    gdouble* user_value,
+    gdouble crop_value) {
+  if (property->format != MPV_FORMAT_DOUBLE) {
+    return;
+  }
+  gdouble value = *(double*)property->data;
+  if (value != crop_value) {
+    *user_value = value;
+    self->crop_stale = TRUE;
+  }
+}
+
+// Drains the weak client's event queue: Updates the cached video dimensions if
+// "video-out-params" changed, tracks the player's own zoom & pan & completes
+// the pending crop. Cheap (a single atomic read) if nothing happened.
+static void video_output_drain_observer(VideoOutput* self) {
+  if (!g_atomic_int_compare_and_exchange(&self->observer_pending, TRUE,
+                                         FALSE)) {
+    return;
+  }
+  gboolean cropped = FALSE;
+  g_mutex_lock(&self->dimensions_mutex);
+  while (TRUE) {
+    mpv_event* event = mpv_wait_event(self->observer, 0);
+    if (event->event_id == MPV_EVENT_NONE) {
+      break;
+    }
+    if (event->event_id == MPV_EVENT_SHUTDOWN) {
+      self->video_width = 0;
+      self->video_height = 0;
+      continue;
+    }
+    if (event->event_id == MPV_EVENT_SET_PROPERTY_REPLY &&
+        event->reply_userdata == VIDEO_OUTPUT_CROP_REPLY) {
+      // mpv applied the crop's zoom & pan: Render at the crop's size now.
+      if (g_atomic_int_dec_and_test(&self->crop_replies)) {
+        self->applied_crop = self->pending_crop;
+        cropped = TRUE;
+      }
+      continue;
+    }
+    if (event->event_id != MPV_EVENT_PROPERTY_CHANGE) {
+      continue;
+    }
+    mpv_event_property* property = (mpv_event_property*)event->data;
+    if (strcmp(property->name, "video-zoom") == 0) {
+      video_output_observe_crop_property(self, property, &self->user_zoom,
+                                         self->crop_zoom);
+      continue;
+    }
+    if (strcmp(property->name, "video-pan-x") == 0) {
+      video_output_observe_crop_property(self, property, &self->user_pan_x,
+                                         self->crop_pan_x);
+      continue;
+    }
+    if (strcmp(property->name, "video-pan-y") == 0) {
+      video_output_observe_crop_property(self, property, &self->user_pan_y,
+                                         self->crop_pan_y);
+      continue;
+    }
+    if (strcmp(property->name, "video-out-params") != 0) {
+      continue;
+    }
+    self->video_width = 0;
+    self->video_height = 0;
+    if (property->format == MPV_FORMAT_NODE) {
+      video_output_parse_video_out_params((mpv_node*)property->data,
+                                          &self->video_width,
+                                          &self->video_height);
+    }
+  }
+  g_mutex_unlock(&self->dimensions_mutex);
+  if (cropped) {
+    video_output_request_render(self);
+  }
+}
+
+// Updates the cached video dimensions. Queries "video-out-params" directly if
+// no weak client could be created.
+static void video_output_update_video_dimensions(VideoOutput* self) {
+  if (self->observer == NULL) {
+    // No weak client could be created: Query the property every time.
+    mpv_node params;
+    gint64 width = 0, height = 0;
+    if (mpv_get_property(self->handle, "video-out-params", MPV_FORMAT_NODE,
+                         &params) >= 0) {
+      video_output_parse_video_out_params(&params, &width, &height);
+      mpv_free_node_contents(&params);
+    }
+    g_mutex_lock(&self->dimensions_mutex);
+    self->video_width = width;
+    self->video_height = height;
+    g_mutex_unlock(&self->dimensions_mutex);
+    return;
+  }
+  video_output_drain_observer(self);
+}
+
+// Combines the player's own zoom & pan with the ones making mpv render only
+// |crop| into the (correspondingly sized) render target. With "keepaspect",
+// mpv fits the whole video into the render target i.e. scales it by the
+// smaller of the crop's width & height. It is zoomed by the inverse of that &
+// panned (in units of the zoomed video) to bring the crop's center to the
+// center. mpv's rendering is clipped to the render target, so the cost scales
+// with the crop's area. Removing the crop restores the player's own values.
+static void video_output_update_crop_properties(VideoOutput* self,
+                                                VideoOutputCrop crop) {
+  gdouble scale = exp2(self->user_zoom);
+  self->crop_zoom = self->user_zoom - log2(MIN(crop.width, crop.height));
+  self->crop_pan_x =
+      self->user_pan_x + (0.5 - (crop.left + crop.width / 2.0)) / scale;
+  self->crop_pan_y =
+      self->user_pan_y + (0.5 - (crop.top + crop.height / 2.0)) / scale;
+}
+
+// Invoked on the render thread, before the render target's size is picked.
+// The crop's zoom & pan are set asynchronously (the render thread must not
+// block on mpv's core) & the crop is only rendered once mpv applied them, so
+// the render target's size & mpv's zoom & pan always match.
+static void video_output_apply_crop(VideoOutput* self) {
+  if (self->observer == NULL) {
+    // Applied right away by |video_output_apply_crop_sync|.
+    return;
+  }
+  video_output_drain_observer(self);
+  g_mutex_lock(&self->dimensions_mutex);
+  // The crop has no effect with a fixed size.
+  VideoOutputCrop crop = self->width ? kVideoOutputNoCrop : self->crop;
+  if (g_atomic_int_get(&self->crop_replies) > 0 ||
+      (!self->crop_stale &&
+       video_output_crop_equal(self->pending_crop, crop))) {
+    g_mutex_unlock(&self->dimensions_mutex);
+    return;
+  }
+  self->crop_stale = FALSE;
+  self->pending_crop = crop;
+  g_atomic_int_set(&self->cropped,
+                   !video_output_crop_equal(crop, kVideoOutputNoCrop));
+  video_output_update_crop_properties(self, crop);
+  gdouble zoom = self->crop_zoom;
+  gdouble pan_x = self->crop_pan_x;
+  gdouble pan_y = self->crop_pan_y;
+  g_atomic_int_set(&self->crop_replies, 3);
+  g_mutex_unlock(&self->dimensions_mutex);
+  const char* names[] = {"video-zoom", "video-pan-x", "video-pan-y"};
+  gdouble values[] = {zoom, pan_x, pan_y};
+  for (gint i = 0; i < 3; i++) {
+    if (mpv_set_property_async(self->observer, VIDEO_OUTPUT_CROP_REPLY,
+                               names[i], MPV_FORMAT_DOUBLE, &values[i]) < 0 &&
+        g_atomic_int_dec_and_test(&self->crop_replies)) {
+      g_mutex_lock(&self->dimensions_mutex);
+      self->applied_crop = self->pending_crop;
+      g_mutex_unlock(&self->dimensions_mutex);
+    }
+  }
+}
+
+// Invoked on the platform thread if no weak client could be created: The
+// player's own zoom & pan are read before cropping & set synchronously.
+static void video_output_apply_crop_sync(VideoOutput* self) {
+  if (self->observer != NULL || self->handle == NULL) {
+    return;
+  }
+  g_mutex_lock(&self->dimensions_mutex);
+  VideoOutputCrop crop = self->width ? kVideoOutputNoCrop : self->crop;
+  VideoOutputCrop applied_crop = self->applied_crop;
+  g_mutex_unlock(&self->dimensions_mutex);
+  if (video_output_crop_equal(applied_crop, crop)) {
+    return;
+  }
+  if (video_output_crop_equal(applied_crop, kVideoOutputNoCrop)) {
+    mpv_get_property(self->handle, "video-zoom", MPV_FORMAT_DOUBLE,
+                     &self->user_zoom);
+    mpv_get_property(self->handle, "video-pan-x", MPV_FORMAT_DOUBLE,
+                     &self->user_pan_x);
+    mpv_get_property(self->handle, "video-pan-y", MPV_FORMAT_DOUBLE,
+                     &self->user_pan_y);
+  }
+  video_output_update_crop_properties(self, crop);
+  mpv_set_property(self->handle, "video-zoom", MPV_FORMAT_DOUBLE,
+                   &self->crop_zoom);
+  mpv_set_property(self->handle, "video-pan-x", MPV_FORMAT_DOUBLE,
+                   &self->crop_pan_x);
+  mpv_set_property(self->handle, "video-pan-y", MPV_FORMAT_DOUBLE,
+                   &self->crop_pan_y);
+  g_mutex_lock(&self->dimensions_mutex);
+  self->applied_crop = crop;
+  g_mutex_unlock(&self->dimensions_mutex);
+}
+
+typedef struct _VideoOutputRenderContextCreateData {
+  VideoOutput* self;
+  mpv_render_param* params;
+  gboolean success;
+} VideoOutputRenderContextCreateData;
+
+// Invoked on the render thread.
+static void video_output_create_render_context(gpointer data) {
+  VideoOutputRenderContextCreateData* create_data =
+      (VideoOutputRenderContextCreateData*)data;
+  VideoOutput* self = create_data->self;
+  if (eglGetCurrentContext() !=
+      render_thread_get_egl_context(self->render_thread)) {
+    return;
+  }
+  create_data->success = mpv_render_context_create(
+                             &self->render_context, self->handle,
+                             create_data->params) == 0;
+}
+
+// Invoked on the render thread after each rendered frame. Steps the render
+// resolution down if the moving average of render time exceeds the budget &
+// back up once there is enough headroom. Render time is assumed to be
+// proportional to the pixel count.
+static void video_output_update_scale(VideoOutput* self, gint64 render_time) {
+  if (self->configuration.render_budget <= 0) {
+    return;
+  }
+  gdouble budget = (gdouble)self->configuration.render_budget;
+  // Exponential moving average, re-seeded after every scale change.
+  gdouble average =
+      self->scale_frames == 0
+          ? render_time
+          : 0.9 * self->render_time.load(std::memory_order_relaxed) +
+                0.1 * render_time;
+  self->render_time.store(average, std::memory_order_relaxed);
+  self->scale_frames++;
+  gint index = g_atomic_int_get(&self->scale_index);
+  gint next = index;
+  if (self->scale_frames >= VIDEO_OUTPUT_SCALE_DOWN_FRAMES &&
+      average > budget && index < VIDEO_OUTPUT_SCALE_COUNT - 1) {
+    next = index + 1;
+  } else if (self->scale_frames >= VIDEO_OUTPUT_SCALE_UP_FRAMES && index > 0) {
+    gdouble ratio = kVideoOutputScales[index - 1] / kVideoOutputScales[index];
+    if (average * ratio * ratio <
+        budget * VIDEO_OUTPUT_SCALE_UP_HEADROOM) {
+      next = index - 1;
+    }
+  }
+  if (next != index) {
+    g_atomic_int_set(&self->scale_index, next);
+    self->scale_frames = 0;
+    self->scale_changes.fetch_add(1, std::memory_order_relaxed);
+    // Re-render the current frame at the new scale.
+    render_thread_request_render(self->render_thread, video_output_render,
+                                 self);
+  }
+}
+
+// Invoked on the render thread.
+// Records the time taken from creation until the first frame is available.
+static void video_output_record_first_frame(VideoOutput* self) {
+  g_mutex_lock(&self->pacing_mutex);
+  if (self->first_frame_time == 0 && self->created_at > 0) {
+    self->first_frame_time =
+        MAX(g_get_monotonic_time() - self->created_at, 1);
+    g_print("media_kit: VideoOutput: First frame after %" G_GINT64_FORMAT
+            " us (created in %" G_GINT64_FORMAT " us%s).\n",
+            self->first_frame_time, self->create_time,
+            self->prewarmed ? ", pre-warmed" : "");
+  }
+  g_mutex_unlock(&self->pacing_mutex);
+}
+
+// Invoked on the render thread. Frame rate cap: Returns whether the current
+// frame (a new one if |new_frame|, otherwise one skipped before) should be
+// rendered now. Of the source's frames, the one due nearest to each tick of
+// |max_fps| is rendered; the others are consumed without rendering (mpv's
+// decoding & A/V sync are left alone). A skipped frame is rendered at the next
+// tick (through |callback|) unless a newer one replaces it, so that e.g. the
+// frame at which playback was paused is shown.
+static gboolean video_output_cap_frame(VideoOutput* self,
+                                       gboolean new_frame,
+                                       RenderThread* render_thread,
+                                       RenderThreadCallback callback) {
+  gint64 interval = (gint64)(G_USEC_PER_SEC / self->configuration.max_fps);
+  gint64 now = g_get_monotonic_time();
+  gint64 due_time = now;
+  if (new_frame) {
+    mpv_render_frame_info info{0, 0};
+    mpv_render_param param{MPV_RENDER_PARAM_NEXT_FRAME_INFO, &info};
+    if (mpv_render_context_get_info(self->render_context, param) >= 0 &&
+        (info.flags & MPV_RENDER_FRAME_INFO_PRESENT) && info.target_time > 0) {
+      due_time = now + info.target_time - mpv_get_time_us(self->handle);
+    }
+    // Ignore gaps e.g. pauses & seeks.
+    gint64 duration = due_time - self->last_due_time;
+    if (self->last_due_time > 0 && duration > 0 &&
+        duration < G_USEC_PER_SEC) {
+      self->frame_duration = self->frame_duration == 0.0
+                                 ? duration
+                                 : 0.9 * self->frame_duration + 0.1 * duration;
+    }
+    self->last_due_time = due_time;
+  }
+  // The next frame is due |frame_duration| later i.e. this one is the nearest
+  // to the tick unless due more than half of it before.
+  if (due_time < self->next_tick - (gint64)(self->frame_duration / 2)) {
+    if (new_frame) {
+      self->capped_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+    self->capped_frame = TRUE;
+    render_thread_request_render_at(render_thread, callback, self,
+                                    self->next_tick);
+    return FALSE;
+  }
+  self->capped_frame = FALSE;
+  // Restart the ticks after falling behind e.g. after a pause.
+  self->next_tick = due_time - self->next_tick >= interval
+                        ? due_time + interval
+                        : self->next_tick + interval;
+  return TRUE;
+}
+
+// Invoked on the render thread after each rendered (new) frame.
+static void video_output_update_fps(VideoOutput* self) {
+  gint64 now = g_get_monotonic_time();
+  gint64 window_start = self->fps_window_start.load(std::memory_order_relaxed);
+  if (window_start == 0) {
+    window_start = now;
+    self->fps_window_start.store(now, std::memory_order_relaxed);
+  }
+  self->fps_window_frames++;
+  gint64 elapsed = now - window_start;
+  if (elapsed >= G_USEC_PER_SEC) {
+    self->fps.store(
+        (gdouble)self->fps_window_frames * G_USEC_PER_SEC / elapsed,
+        std::memory_order_relaxed);
+    self->fps_window_start.store(now, std::memory_order_relaxed);
+    self->fps_window_frames = 0;
+  }
+}
+
+static void video_output_render(gpointer data) {
+  VideoOutput* self = (VideoOutput*)data;
+  if (self->destroyed) {
+    return;
+  }
+  video_output_apply_crop(self);
+  // Only render if mpv has a new video frame. Otherwise the last rendered
+  // frame is reused (unless dimensions changed in the meantime).
+  uint64_t flags = mpv_render_context_update(self->render_context);
+  gboolean new_frame = (flags & MPV_RENDER_UPDATE_FRAME) != 0;
+  gboolean pending = self->pending_frame;
+  gboolean frame = new_frame || pending;
+  self->pending_frame = FALSE;
+  // Hidden: Consume new frames without rendering them (keeps playback going),
+  // unless the rendered frames are consumed elsewhere.
+  if (!g_atomic_int_get(&self->visible) && self->frame_callbacks->len == 0 &&
+      !texture_gl_has_consumers(self->texture_gl)) {
+    if (frame) {
+      mpv_opengl_fbo fbo{0, 1, 1, 0};
+      int skip_rendering = 1;
+      mpv_render_param params[] = {
+          {MPV_RENDER_PARAM_OPENGL_FBO, &fbo},
+          {MPV_RENDER_PARAM_SKIP_RENDERING, &skip_rendering},
+          {MPV_RENDER_PARAM_INVALID, NULL},
+      };
+      mpv_render_context_render(self->render_context, params);
+      self->stale = TRUE;
+      self->suspended_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+  // Frame rate cap. Frames deferred by frame pacing already passed it.
+  if (self->configuration.max_fps > 0 && !pending &&
+      (new_frame || self->capped_frame)) {
+    frame = video_output_cap_frame(self, new_frame, self->render_thread,
+                                   video_output_render);
+    if (!frame && new_frame) {
+      // Consume the frame without rendering it (keeps playback going).
+      mpv_opengl_fbo fbo{0, 1, 1, 0};
+      int skip_rendering = 1;
+      mpv_render_param params[] = {
+          {MPV_RENDER_PARAM_OPENGL_FBO, &fbo},
+          {MPV_RENDER_PARAM_SKIP_RENDERING, &skip_rendering},
+          {MPV_RENDER_PARAM_INVALID, NULL},
+      };
+      mpv_render_context_render(self->render_context, params);
+    }
+  }
+  // Render the newest frame (skipped while hidden) right away.
+  if (self->stale) {
+    frame = TRUE;
+    self->stale = FALSE;
+  }
+  // Frame pacing: Render the new frame shortly before mpv's target time (at
+  // which it should be displayed), instead of right away or blocking in mpv.
+  gint64 target_time = 0;
+  if (self->configuration.frame_pacing && frame) {
+    mpv_render_frame_info info{0, 0};
+    mpv_render_param param{MPV_RENDER_PARAM_NEXT_FRAME_INFO, &info};
+    if (mpv_render_context_get_info(self->render_context, param) >= 0 &&
+        (info.flags & MPV_RENDER_FRAME_INFO_PRESENT) && info.target_time > 0) {
+      // Leave half a refresh interval for rendering & Flutter picking it up.
+      gint64 delay = info.target_time - mpv_get_time_us(self->handle) -
+                     self->refresh_interval / 2;
+      if (delay > 0 && delay < G_USEC_PER_SEC) {
+        self->pending_frame = TRUE;
+        self->deferred_renders.fetch_add(1, std::memory_order_relaxed);
+        render_thread_request_render_at(self->render_thread,
+                                        video_output_render, self,
+                                        g_get_monotonic_time() + delay);
+        return;
+      }
+      target_time = info.target_time;
+    }
+  }
+  if (frame) {
+    frame_latency_begin(self->frame_latency);
+  }
+  gint64 start = g_get_monotonic_time();
+  if (texture_gl_render(self->texture_gl, frame, target_time)) {
+    video_output_update_scale(self, g_get_monotonic_time() - start);
+    if (frame) {
+      video_output_update_fps(self);
+    }
+    texture_gl_mark_frame_available(self->texture_gl, self->texture_registrar);
+    frame_latency_record(self->frame_latency, FRAME_LATENCY_STAGE_MARKED);
+    for (guint i = 0; i < self->frame_callbacks->len; i++) {
+      VideoOutputFrameCallback* frame_callback =
+          &g_array_index(self->frame_callbacks, VideoOutputFrameCallback, i);
+      frame_callback->callback(frame_callback->context);
+    }
+  }
+}
+
+#ifdef MPV_RENDER_API_TYPE_SW
+// Invoked on the GTK main thread. The only part of S/W rendering which is.
+static gboolean video_output_mark_frame_available_sw(gpointer data) {
+  VideoOutput* self = (VideoOutput*)data;
+  gint64 start = g_get_monotonic_time();
+  g_mutex_lock(&self->sw_mark_mutex);
+  self->sw_mark_source = 0;
+  g_mutex_unlock(&self->sw_mark_mutex);
+  fl_texture_registrar_mark_texture_frame_available(
+      self->texture_registrar, FL_TEXTURE(self->texture_sw));
+  frame_latency_record(self->frame_latency, FRAME_LATENCY_STAGE_MARKED);
+  g_mutex_lock(&self->sw_mark_mutex);
+  self->main_thread_frames++;
+  self->main_thread_time += g_get_monotonic_time() - start;
+  g_mutex_unlock(&self->sw_mark_mutex);
+  return G_SOURCE_REMOVE;
+}
+
+// Invoked on |sw_render_thread|, only for a buffer not held by Flutter.
+static void video_output_reserve_pixel_buffer(
+    VideoOutput* self,
+    VideoOutputPixelBuffer* pixel_buffer,
+    gsize size) {
+  gsize capacity = pixel_buffer_pool_get_capacity(size);
+  // Grow as needed, shrink only on a large drop (no churn while resizing).
+  if (pixel_buffer->data != NULL && pixel_buffer->capacity >= capacity &&
+      pixel_buffer->capacity <
+          capacity * VIDEO_OUTPUT_PIXEL_BUFFER_SHRINK_FACTOR) {
+    return;
+  }
+  pixel_buffer_pool_release(pixel_buffer->data, pixel_buffer->capacity);
+  pixel_buffer->data = pixel_buffer_pool_acquire(size);
+  pixel_buffer->capacity = capacity;
+  guint64 memory = 0;
+  for (gint i = 0; i < SW_RENDERING_PIXEL_BUFFER_COUNT; i++) {
+    memory += self->pixel_buffers[i].capacity;
+  }
+  video_output_set_memory(self, memory);
+}
+
+// Invoked on |sw_render_thread|.
+static void video_output_render_sw(gpointer data) {
+  VideoOutput* self = (VideoOutput*)data;
+  if (self->destroyed) {
+    return;
+  }
+  video_output_apply_crop(self);
+  gboolean rendered = FALSE;
+  gint64 width = video_output_get_width(self);
+  gint64 height = video_output_get_height(self);
+  if (width > 0 && height > 0) {
+    uint64_t flags = mpv_render_context_update(self->render_context);
+    gboolean new_frame = (flags & MPV_RENDER_UPDATE_FRAME) != 0;
+    // Hidden: Consume the frame without rendering it (keeps playback going).
+    int skip_rendering = !g_atomic_int_get(&self->visible);
+    gboolean capped = FALSE;
+    if (!skip_rendering && self->configuration.max_fps > 0 &&
+        (new_frame || self->capped_frame)) {
+      capped = !video_output_cap_frame(self, new_frame, self->sw_render_thread,
+                                       video_output_render_sw);
+      if (capped && !new_frame) {
+        // The skipped frame is rendered at the next tick.
+        return;
+      }
+      skip_rendering = capped;
+    }
+    // Render into a buffer which neither holds the newest complete frame nor
+    // is held by Flutter. Only this thread changes the former & Flutter can
+    // only take the former, so the buffer stays free while rendering.
+    gint state = g_atomic_int_get(&self->pixel_buffer_state);
+    gint index = 0;
+    while (index == VIDEO_OUTPUT_PIXEL_BUFFER_LATEST(state) ||
+           index == VIDEO_OUTPUT_PIXEL_BUFFER_PRESENTED(state)) {
+      index++;
+    }
+    VideoOutputPixelBuffer* pixel_buffer = &self->pixel_buffers[index];
+    video_output_reserve_pixel_buffer(self, pixel_buffer, 4 * width * height);
+    gint32 size[]{(gint32)width, (gint32)height};
+    gint32 pitch = 4 * (gint32)width;
+    if (!skip_rendering) {
+      frame_latency_begin(self->frame_latency);
+    }
+    mpv_render_param params[]{
+        {MPV_RENDER_PARAM_SW_SIZE, size},
+        {MPV_RENDER_PARAM_SW_FORMAT, (void*)"rgb0"},
+        {MPV_RENDER_PARAM_SW_STRIDE, &pitch},
+        {MPV_RENDER_PARAM_SW_POINTER, pixel_buffer->data},
+        {MPV_RENDER_PARAM_SKIP_RENDERING, &skip_rendering},
+        {MPV_RENDER_PARAM_INVALID, (void*)0},
+    };
+    mpv_render_context_render(self->render_context, params);
+    if (skip_rendering) {
+      // Capped frames are counted by |video_output_cap_frame|.
+      if (!capped) {
+        self->suspended_frames.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else {
+      frame_latency_record(self->frame_latency, FRAME_LATENCY_STAGE_RENDERED);
+      pixel_buffer->width = width;
+      pixel_buffer->height = height;
+      pixel_buffer->crop = video_output_get_crop(self);
+      // Publish as the newest complete frame.
+      do {
+        state = g_atomic_int_get(&self->pixel_buffer_state);
+      } while (!g_atomic_int_compare_and_exchange(
+          &self->pixel_buffer_state, state,
+          VIDEO_OUTPUT_PIXEL_BUFFER_STATE(
+              index, VIDEO_OUTPUT_PIXEL_BUFFER_PRESENTED(state))));
+      video_output_update_fps(self);
+      rendered = TRUE;
+    }
+  }
+  if (rendered) {
+    // Post the notification to the main thread, coalesced with a pending one.
+    g_mutex_lock(&self->sw_mark_mutex);
+    if (self->sw_mark_source == 0) {
+      self->sw_mark_source = g_idle_add(video_output_mark_frame_available_sw,
+                                        self);
+    }
+    g_mutex_unlock(&self->sw_mark_mutex);
+  }
+}
+
+// Invoked on |sw_render_thread|.
+static void video_output_release_render_resources_sw(gpointer data) {
+  VideoOutput* self = (VideoOutput*)data;
+  render_thread_cancel(self->sw_render_thread, self);
+  if (self->render_context != NULL) {
+    mpv_render_context_free(self->render_context);
+    self->render_context = NULL;
+  }
+}
+#endif
+
+// Invoked on the render thread.
+static void video_output_release_render_resources(gpointer data) {
+  VideoOutput* self = (VideoOutput*)data;
+  render_thread_cancel(self->render_thread, self);
+  if (self->render_context != NULL) {
+    mpv_render_context_free(self->render_context);
+    self->render_context = NULL;
+  }
+  texture_gl_release(self->texture_gl);
+}
+
 static void video_output_dispose(GObject* object) {
   VideoOutput* self = VIDEO_OUTPUT(object);
   self->destroyed = TRUE;
@@ -45,45 +796,53 @@ static void video_output_dispose(GObject* object) {
   if (self->render_context) {
     mpv_render_context_set_update_callback(self->render_context, NULL, NULL);
   }
+  if (self->observer != NULL) {
+    mpv_set_wakeup_callback(self->observer, NULL, NULL);
+    mpv_destroy(self->observer);
+    self->observer = NULL;
+  }
 
+  // Mirrors
+  for (guint i = 0; i < self->mirrors->len; i++) {
+    fl_texture_registrar_unregister_texture(
+        self->texture_registrar, FL_TEXTURE(g_ptr_array_index(self->mirrors, i)));
+  }
+  g_ptr_array_set_size(self->mirrors, 0);
   // H/W
   if (self->texture_gl) {
     fl_texture_registrar_unregister_texture(self->texture_registrar,
                                             FL_TEXTURE(self->texture_gl));
-    
-    // Save Flutter's current context before cleanup
-    EGLDisplay current_display = eglGetCurrentDisplay();
-    EGLContext flutter_context = eglGetCurrentContext();
-    EGLSurface flutter_draw_surface = eglGetCurrentSurface(EGL_DRAW);
-    EGLSurface flutter_read_surface = eglGetCurrentSurface(EGL_READ);
-    
-    // Free mpv_render_context with our own isolated EGL context
-    if (self->render_context != NULL) {
-      if (self->egl_context != EGL_NO_CONTEXT) {
-        eglMakeCurrent(self->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, self->egl_context);
-      }
-      mpv_render_context_free(self->render_context);
-      self->render_context = NULL;
-      
-      // Restore Flutter's context
-      if (flutter_context != EGL_NO_CONTEXT) {
-        eglMakeCurrent(current_display, flutter_draw_surface, flutter_read_surface, flutter_context);
-      }
+    if (self->render_thread != NULL) {
+      // Free mpv_render_context & mpv's OpenGL resources on the render thread
+      // i.e. with our own isolated EGL context current.
+      render_thread_invoke(self->render_thread,
+                           video_output_release_render_resources, self);
+      g_object_unref(self->render_thread);
+      self->render_thread = NULL;
     }
-    
-    // Clean up EGL resources
-    if (self->egl_context != EGL_NO_CONTEXT) {
-      eglDestroyContext(self->egl_display, self->egl_context);
-      self->egl_context = EGL_NO_CONTEXT;
-    }
-    
     g_object_unref(self->texture_gl);
   }
   // S/W
   if (self->texture_sw) {
+#ifdef MPV_RENDER_API_TYPE_SW
+    if (self->sw_render_thread != NULL) {
+      render_thread_invoke(self->sw_render_thread,
+                           video_output_release_render_resources_sw, self);
+      g_clear_object(&self->sw_render_thread);
+    }
+#endif
+    // No further frame is posted by the S/W render thread.
+    if (self->sw_mark_source != 0) {
+      g_source_remove(self->sw_mark_source);
+      self->sw_mark_source = 0;
+    }
     fl_texture_registrar_unregister_texture(self->texture_registrar,
                                             FL_TEXTURE(self->texture_sw));
-    g_free(self->pixel_buffer);
+    for (gint i = 0; i < SW_RENDERING_PIXEL_BUFFER_COUNT; i++) {
+      pixel_buffer_pool_release(self->pixel_buffers[i].data,
+                                self->pixel_buffers[i].capacity);
+      self->pixel_buffers[i].data = NULL;
+    }
     g_object_unref(self->texture_sw);
     if (self->render_context != NULL) {
       mpv_render_context_free(self->render_context);
@@ -91,43 +850,184 @@ static void video_output_dispose(GObject* object) {
     }
   }
   
-  g_mutex_clear(&self->mutex);
+  video_output_set_memory(self, 0);
+  g_mutex_clear(&self->sw_mark_mutex);
+  g_mutex_clear(&self->dimensions_mutex);
+  g_mutex_clear(&self->pacing_mutex);
   G_OBJECT_CLASS(video_output_parent_class)->dispose(object);
 }
 
+static void video_output_finalize(GObject* object) {
+  VideoOutput* self = VIDEO_OUTPUT(object);
+  g_ptr_array_unref(self->mirrors);
+  g_array_unref(self->frame_callbacks);
+  frame_latency_free(self->frame_latency);
+  G_OBJECT_CLASS(video_output_parent_class)->finalize(object);
+}
+
 static void video_output_class_init(VideoOutputClass* klass) {
   G_OBJECT_CLASS(klass)->dispose = video_output_dispose;
+  G_OBJECT_CLASS(klass)->finalize = video_output_finalize;
 }
 
 static void video_output_init(VideoOutput* self) {
   self->texture_gl = NULL;
+  self->mirrors = g_ptr_array_new_with_free_func(g_object_unref);
+  self->frame_callbacks =
+      g_array_new(FALSE, FALSE, sizeof(VideoOutputFrameCallback));
   self->egl_display = EGL_NO_DISPLAY;
-  self->egl_context = EGL_NO_CONTEXT;
+  self->render_thread = NULL;
   self->egl_surface = EGL_NO_SURFACE;
   self->texture_sw = NULL;
-  self->pixel_buffer = NULL;
+  for (gint i = 0; i < SW_RENDERING_PIXEL_BUFFER_COUNT; i++) {
+    self->pixel_buffers[i].data = NULL;
+    self->pixel_buffers[i].capacity = 0;
+    self->pixel_buffers[i].width = 0;
+    self->pixel_buffers[i].height = 0;
+    self->pixel_buffers[i].crop = kVideoOutputNoCrop;
+  }
+  self->pixel_buffer_state = VIDEO_OUTPUT_PIXEL_BUFFER_STATE(-1, -1);
+  self->sw_render_thread = NULL;
+  self->sw_mark_source = 0;
+  self->main_thread_frames = 0;
+  self->main_thread_time = 0;
   self->handle = NULL;
+  self->observer = NULL;
+  self->observer_pending = FALSE;
+  self->video_width = 0;
+  self->video_height = 0;
   self->render_context = NULL;
   self->width = 0;
   self->height = 0;
+  self->display_width = 0;
+  self->display_height = 0;
+  self->crop = kVideoOutputNoCrop;
+  self->applied_crop = kVideoOutputNoCrop;
+  self->pending_crop = kVideoOutputNoCrop;
+  self->crop_replies = 0;
+  self->cropped = FALSE;
+  self->crop_stale = FALSE;
+  self->user_zoom = 0.0;
+  self->user_pan_x = 0.0;
+  self->user_pan_y = 0.0;
+  self->crop_zoom = 0.0;
+  self->crop_pan_x = 0.0;
+  self->crop_pan_y = 0.0;
+  self->scale_index = 0;
+  self->render_time.store(0.0, std::memory_order_relaxed);
+  self->scale_frames = 0;
+  self->scale_changes.store(0, std::memory_order_relaxed);
+  self->visible = TRUE;
+  self->stale = FALSE;
+  self->suspended_frames.store(0, std::memory_order_relaxed);
+  self->refresh_interval = G_USEC_PER_SEC / 60;
+  self->pending_frame = FALSE;
+  self->deferred_renders.store(0, std::memory_order_relaxed);
+  self->next_tick = 0;
+  self->last_due_time = 0;
+  self->frame_duration = 0.0;
+  self->capped_frame = FALSE;
+  self->capped_frames.store(0, std::memory_order_relaxed);
+  self->fps_window_start.store(0, std::memory_order_relaxed);
+  self->fps_window_frames = 0;
+  self->fps.store(0.0, std::memory_order_relaxed);
+  self->last_present_time = 0;
+  self->last_target_time = 0;
+  self->presented_frames = 0;
+  self->late_frames = 0;
+  self->judder_frames = 0;
+  g_mutex_init(&self->pacing_mutex);
+  self->frame_latency = NULL;
+  self->memory = 0;
+  self->prewarmed = FALSE;
+  self->create_time = 0;
+  self->created_at = 0;
+  self->first_frame_time = 0;
   self->configuration = VideoOutputConfiguration{};
   self->texture_update_callback = NULL;
   self->texture_update_callback_context = NULL;
   self->texture_registrar = NULL;
   self->destroyed = FALSE;
-  g_mutex_init(&self->mutex);
+  g_mutex_init(&self->sw_mark_mutex);
+  g_mutex_init(&self->dimensions_mutex);
+}
+
+// Refresh interval (microseconds) of the monitor showing |view|, 60 Hz if
+// unknown.
+static gint64 video_output_get_refresh_interval(FlView* view) {
+  GdkDisplay* display = gdk_display_get_default();
+  if (display == NULL) {
+    return G_USEC_PER_SEC / 60;
+  }
+  GdkWindow* window =
+      view != NULL ? gtk_widget_get_window(GTK_WIDGET(view)) : NULL;
+  GdkMonitor* monitor = window != NULL
+                            ? gdk_display_get_monitor_at_window(display, window)
+                            : NULL;
+  if (monitor == NULL) {
+    monitor = gdk_display_get_primary_monitor(display);
+  }
+  // Millihertz.
+  gint refresh_rate = monitor != NULL ? gdk_monitor_get_refresh_rate(monitor) : 0;
+  if (refresh_rate <= 0) {
+    return G_USEC_PER_SEC / 60;
+  }
+  return (gint64)G_USEC_PER_SEC * 1000 / refresh_rate;
+}
+
+// Records the time taken by |video_output_new| started at |start_time|.
+static void video_output_set_create_time(VideoOutput* self,
+                                         gint64 start_time) {
+  g_mutex_lock(&self->pacing_mutex);
+  self->created_at = g_get_monotonic_time();
+  self->create_time = self->created_at - start_time;
+  g_mutex_unlock(&self->pacing_mutex);
+}
+
+EGLConfig video_output_get_flutter_egl_config(EGLDisplay egl_display,
+                                              EGLContext egl_context) {
+  EGLConfig config = NULL;
+  EGLint config_id = 0;
+  if (!eglQueryContext(egl_display, egl_context, EGL_CONFIG_ID, &config_id)) {
+    g_printerr("media_kit: VideoOutput: Failed to query Flutter's EGL config ID.\n");
+    return NULL;
+  }
+  g_print("media_kit: VideoOutput: Flutter's EGL config ID: %d\n", config_id);
+  // Get Flutter's exact config
+  EGLint num_configs = 0;
+  EGLint config_attribs[] = {EGL_CONFIG_ID, config_id, EGL_NONE};
+  if (!eglChooseConfig(egl_display, config_attribs, &config, 1,
+                       &num_configs) ||
+      num_configs == 0) {
+    g_printerr("media_kit: VideoOutput: Failed to get Flutter's EGL config by ID.\n");
+    return NULL;
+  }
+  g_print("media_kit: VideoOutput: Using Flutter's EGL config.\n");
+  return config;
 }
 
 VideoOutput* video_output_new(FlTextureRegistrar* texture_registrar,
                               FlView* view,
                               gint64 handle,
-                              VideoOutputConfiguration configuration) {
+                              VideoOutputConfiguration configuration,
+                              RenderThread* render_thread,
+                              VideoOutputPrewarmed* prewarmed) {
+  gint64 start_time = g_get_monotonic_time();
   VideoOutput* self = VIDEO_OUTPUT(g_object_new(video_output_get_type(), NULL));
   self->texture_registrar = texture_registrar;
   self->handle = (mpv_handle*)handle;
   self->width = configuration.width;
   self->height = configuration.height;
   self->configuration = configuration;
+  if (self->configuration.sw_max_width <= 0 ||
+      self->configuration.sw_max_height <= 0) {
+    self->configuration.sw_max_width = SW_RENDERING_MAX_WIDTH;
+    self->configuration.sw_max_height = SW_RENDERING_MAX_HEIGHT;
+  }
+  self->refresh_interval = video_output_get_refresh_interval(view);
+  if (self->configuration.measure_frame_latency) {
+    self->frame_latency = frame_latency_new();
+  }
 #ifndef MPV_RENDER_API_TYPE_SW
   // MPV_RENDER_API_TYPE_SW must be available for S/W rendering.
   if (!self->configuration.enable_hardware_acceleration) {
@@ -135,6 +1035,23 @@ VideoOutput* video_output_new(FlTextureRegistrar* texture_registrar,
   }
   self->configuration.enable_hardware_acceleration = TRUE;
 #endif
+  // Observe "video-out-params" through a weak client (does not keep the
+  // player alive & does not interfere with the player's own event loop),
+  // instead of querying it from the render path.
+  self->observer = mpv_create_weak_client(self->handle, NULL);
+  if (self->observer != NULL) {
+    mpv_set_wakeup_callback(self->observer, video_output_observer_wakeup,
+                            self);
+    mpv_observe_property(self->observer, 0, "video-out-params",
+                         MPV_FORMAT_NODE);
+    // The player's own zoom & pan, combined with the crop.
+    mpv_observe_property(self->observer, 0, "video-zoom", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(self->observer, 0, "video-pan-x", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(self->observer, 0, "video-pan-y", MPV_FORMAT_DOUBLE);
+  } else {
+    // "video-out-params" is then queried directly.
+    g_printerr("media_kit: VideoOutput: mpv_create_weak_client failed.\n");
+  }
   mpv_set_option_string(self->handle, "video-sync", "audio");
   // Causes frame drops with `pulse` audio output. (SlotSun/dart_simple_live#42)
   // mpv_set_option_string(self->handle, "video-timing-offset", "0");
@@ -143,108 +1060,117 @@ VideoOutput* video_output_new(FlTextureRegistrar* texture_registrar,
     // Get Flutter's current EGL display (DO NOT share context)
     EGLDisplay flutter_display = eglGetCurrentDisplay();
     EGLContext flutter_context = eglGetCurrentContext();
-    EGLSurface flutter_draw_surface = eglGetCurrentSurface(EGL_DRAW);
-    EGLSurface flutter_read_surface = eglGetCurrentSurface(EGL_READ);
     
     if (flutter_display != EGL_NO_DISPLAY && flutter_context != EGL_NO_CONTEXT) {
       self->egl_display = flutter_display;
       
-      // Bind OpenGL ES API (Flutter uses OpenGL ES on Linux)
-      eglBindAPI(EGL_OPENGL_ES_API);
-      
       // Query Flutter's EGL config and reuse it for compatibility
       EGLConfig config = NULL;
-      EGLint config_id = 0;
       
-      if (eglQueryContext(self->egl_display, flutter_context, EGL_CONFIG_ID, &config_id)) {
-        g_print("media_kit: VideoOutput: Flutter's EGL config ID: %d\n", config_id);
-        
-        // Get Flutter's exact config
-        EGLint num_configs = 0;
-        EGLint config_attribs[] = { EGL_CONFIG_ID, config_id, EGL_NONE };
-        
-        if (eglChooseConfig(self->egl_display, config_attribs, &config, 1, &num_configs) && num_configs > 0) {
-          g_print("media_kit: VideoOutput: Using Flutter's EGL config.\n");
-        } else {
-          g_printerr("media_kit: VideoOutput: Failed to get Flutter's EGL config by ID.\n");
-          config = NULL;
+      if (render_thread != NULL &&
+          render_thread_get_egl_display(render_thread) == self->egl_display &&
+          render_thread_get_egl_context(render_thread) != EGL_NO_CONTEXT) {
+        // Render on the shared render thread i.e. with its EGL context.
+        self->render_thread = RENDER_THREAD(g_object_ref(render_thread));
+        g_print("media_kit: VideoOutput: Using shared render thread.\n");
+      } else if (prewarmed != NULL && prewarmed->render_thread != NULL &&
+                 render_thread_get_egl_display(prewarmed->render_thread) ==
+                     self->egl_display) {
+        // Adopt the pre-warmed render thread (& texture) i.e. skip creating
+        // the isolated EGL context & registering the texture.
+        self->render_thread = prewarmed->render_thread;
+        prewarmed->render_thread = NULL;
+        if (prewarmed->texture_gl != NULL) {
+          self->texture_gl = prewarmed->texture_gl;
+          prewarmed->texture_gl = NULL;
+          texture_gl_set_video_output(self->texture_gl, self);
         }
+        self->prewarmed = TRUE;
+        g_print("media_kit: VideoOutput: Using pre-warmed render thread.\n");
       } else {
-        g_printerr("media_kit: VideoOutput: Failed to query Flutter's EGL config ID.\n");
+        config = video_output_get_flutter_egl_config(self->egl_display,
+                                                     flutter_context);
       }
       
-      if (config != NULL) {        
-        // Create an isolated EGL context (NOT shared with Flutter)
-        // This prevents OpenGL state pollution and resource contention
-        EGLint context_attribs[] = {
-            EGL_CONTEXT_CLIENT_VERSION, 2,
-            EGL_NONE,
-        };
-        
-        self->egl_context = eglCreateContext(self->egl_display, config, 
-                                             EGL_NO_CONTEXT, context_attribs);
+      if (self->render_thread != NULL || config != NULL) {
+        // The isolated EGL context is owned by the render thread & stays
+        // current there. Flutter's context is never switched.
+        if (self->render_thread == NULL) {
+          self->render_thread = render_thread_new(self->egl_display, config);
+        }
         
-        if (self->egl_context != EGL_NO_CONTEXT) {
-          // Make our isolated context current for initialization (surfaceless)
-          if (eglMakeCurrent(self->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, self->egl_context)) {
-            // Create texture with our isolated context
+        if (render_thread_get_egl_context(self->render_thread) != EGL_NO_CONTEXT) {
+          // An adopted texture is already registered.
+          gboolean registered = self->texture_gl != NULL;
+          if (self->texture_gl == NULL) {
             self->texture_gl = texture_gl_new(self);
+          }
+          
+          if (registered ||
+              fl_texture_registrar_register_texture(
+                  texture_registrar, FL_TEXTURE(self->texture_gl))) {
+            // Initialize mpv with our isolated EGL context
+            mpv_opengl_init_params gl_init_params{
+                [](auto, auto name) {
+                  return (void*)eglGetProcAddress(name);
+                },
+                NULL,
+            };
             
-            if (fl_texture_registrar_register_texture(
-                    texture_registrar, FL_TEXTURE(self->texture_gl))) {
-              // Initialize mpv with our isolated EGL context
-              mpv_opengl_init_params gl_init_params{
-                  [](auto, auto name) {
-                    return (void*)eglGetProcAddress(name);
+            mpv_render_param params[] = {
+                {MPV_RENDER_PARAM_API_TYPE, (void*)MPV_RENDER_API_TYPE_OPENGL},
+                {MPV_RENDER_PARAM_OPENGL_INIT_PARAMS, (void*)&gl_init_params},
+                {MPV_RENDER_PARAM_INVALID, (void*)0},
+                {MPV_RENDER_PARAM_INVALID, (void*)0},
+            };
+            
+            // VAAPI acceleration requires passing X11/Wayland display
+            GdkDisplay* display = gdk_display_get_default();
+            if (GDK_IS_WAYLAND_DISPLAY(display)) {
+              params[2].type = MPV_RENDER_PARAM_WL_DISPLAY;
+              params[2].data = gdk_wayland_display_get_wl_display(display);
+            } else if (GDK_IS_X11_DISPLAY(display)) {
+              params[2].type = MPV_RENDER_PARAM_X11_DISPLAY;
+              params[2].data = gdk_x11_display_get_xdisplay(display);
+            }
+            
+            // mpv_render_context must be created on the thread where the
+            // isolated EGL context is current.
+            VideoOutputRenderContextCreateData create_data{self, params, FALSE};
+            render_thread_invoke(self->render_thread,
+                                 video_output_create_render_context,
+                                 &create_data);
+            
+            if (create_data.success) {
+              mpv_render_context_set_update_callback(
+                  self->render_context,
+                  [](void* data) {
+                    VideoOutput* self = (VideoOutput*)data;
+                    if (self->destroyed) {
+                      return;
+                    }
+                    frame_latency_update(self->frame_latency);
+                    render_thread_request_render(self->render_thread,
+                                                 video_output_render, self);
                   },
-                  NULL,
-              };
-              
-              mpv_render_param params[] = {
-                  {MPV_RENDER_PARAM_API_TYPE, (void*)MPV_RENDER_API_TYPE_OPENGL},
-                  {MPV_RENDER_PARAM_OPENGL_INIT_PARAMS, (void*)&gl_init_params},
-                  {MPV_RENDER_PARAM_INVALID, (void*)0},
-                  {MPV_RENDER_PARAM_INVALID, (void*)0},
-              };
-              
-              // VAAPI acceleration requires passing X11/Wayland display
-              GdkDisplay* display = gdk_display_get_default();
-              if (GDK_IS_WAYLAND_DISPLAY(display)) {
-                params[2].type = MPV_RENDER_PARAM_WL_DISPLAY;
-                params[2].data = gdk_wayland_display_get_wl_display(display);
-              } else if (GDK_IS_X11_DISPLAY(display)) {
-                params[2].type = MPV_RENDER_PARAM_X11_DISPLAY;
-                params[2].data = gdk_x11_display_get_xdisplay(display);
-              }
-              
-              if (mpv_render_context_create(&self->render_context, self->handle, params) == 0) {
-                mpv_render_context_set_update_callback(
-                    self->render_context,
-                    [](void* data) {
-                      VideoOutput* self = (VideoOutput*)data;
-                      if (self->destroyed) {
-                        return;
-                      }
-                      fl_texture_registrar_mark_texture_frame_available(
-                          self->texture_registrar, FL_TEXTURE(self->texture_gl));
-                    },
-                    self);
-                hardware_acceleration_supported = TRUE;
-                g_print("media_kit: VideoOutput: H/W rendering with isolated EGL context.\n");
-              } else {
-                g_printerr("media_kit: VideoOutput: Failed to create mpv_render_context.\n");
-              }
+                  self);
+              hardware_acceleration_supported = TRUE;
+              g_print("media_kit: VideoOutput: H/W rendering on dedicated render thread.\n");
             } else {
-              g_printerr("media_kit: VideoOutput: Failed to register texture.\n");
+              g_printerr("media_kit: VideoOutput: Failed to create mpv_render_context.\n");
+              fl_texture_registrar_unregister_texture(
+                  texture_registrar, FL_TEXTURE(self->texture_gl));
             }
-            
-            // Restore Flutter's context
-            eglMakeCurrent(flutter_display, flutter_draw_surface, flutter_read_surface, flutter_context);
           } else {
-            g_printerr("media_kit: VideoOutput: Failed to make isolated EGL context current. Error: 0x%x\n", eglGetError());
+            g_printerr("media_kit: VideoOutput: Failed to register texture.\n");
           }
         } else {
-          g_printerr("media_kit: VideoOutput: Failed to create isolated EGL context. Error: 0x%x\n", eglGetError());
+          g_printerr("media_kit: VideoOutput: Failed to create isolated EGL context.\n");
+        }
+        
+        if (!hardware_acceleration_supported) {
+          g_clear_object(&self->texture_gl);
+          g_clear_object(&self->render_thread);
         }
       } else {
         g_printerr("media_kit: VideoOutput: Could not obtain Flutter's EGL config.\n");
@@ -257,7 +1183,7 @@ VideoOutput* video_output_new(FlTextureRegistrar* texture_registrar,
   if (!hardware_acceleration_supported) {
     g_printerr("media_kit: VideoOutput: S/W rendering.\n");
     // H/W rendering failed. Fallback to S/W rendering.
-    self->pixel_buffer = g_new0(guint8, SW_RENDERING_PIXEL_BUFFER_SIZE);
+    // Pixel buffers are acquired on first render, sized to the frame.
     self->texture_gl = NULL;
     self->texture_sw = texture_sw_new(self);
     if (fl_texture_registrar_register_texture(texture_registrar,
@@ -268,43 +1194,26 @@ VideoOutput* video_output_new(FlTextureRegistrar* texture_registrar,
       };
       if (mpv_render_context_create(&self->render_context, self->handle,
                                     params) == 0) {
+        // Render off the GTK main thread, only marking frames available is
+        // posted back to it.
+        self->sw_render_thread = render_thread_new_sw();
         mpv_render_context_set_update_callback(
             self->render_context,
             [](void* data) {
-              gdk_threads_add_idle(
-                  [](gpointer data) -> gboolean {
-                    VideoOutput* self = (VideoOutput*)data;
-                    if (self->destroyed) {
-                      return FALSE;
-                    }
-                    g_mutex_lock(&self->mutex);
-                    gint64 width = video_output_get_width(self);
-                    gint64 height = video_output_get_height(self);
-                    if (width > 0 && height > 0) {
-                      gint32 size[]{(gint32)width, (gint32)height};
-                      gint32 pitch = 4 * (gint32)width;
-                      mpv_render_param params[]{
-                          {MPV_RENDER_PARAM_SW_SIZE, size},
-                          {MPV_RENDER_PARAM_SW_FORMAT, (void*)"rgb0"},
-                          {MPV_RENDER_PARAM_SW_STRIDE, &pitch},
-                          {MPV_RENDER_PARAM_SW_POINTER, self->pixel_buffer},
-                          {MPV_RENDER_PARAM_INVALID, (void*)0},
-                      };
-                      mpv_render_context_render(self->render_context, params);
-                      fl_texture_registrar_mark_texture_frame_available(
-                          self->texture_registrar,
-                          FL_TEXTURE(self->texture_sw));
-                    }
-                    g_mutex_unlock(&self->mutex);
-                    return FALSE;
-                  },
-                  data);
+              VideoOutput* self = (VideoOutput*)data;
+              if (self->destroyed) {
+                return;
+              }
+              frame_latency_update(self->frame_latency);
+              render_thread_request_render(self->sw_render_thread,
+                                           video_output_render_sw, self);
             },
             self);
       }
     }
   }
 #endif
+  video_output_set_create_time(self, start_time);
   return self;
 }
 
@@ -322,10 +1231,13 @@ void video_output_set_texture_update_callback(
   // never ending deadlock where no video frames are ever rendered.
   gint64 texture_id = video_output_get_texture_id(self);
   if (self->width == 0 || self->height == 0) {
-    self->texture_update_callback(texture_id, 1, 1,
+    self->texture_update_callback(texture_id, 1, 1, 1, 1, 1.0,
+                                  kVideoOutputNoCrop,
                                   self->texture_update_callback_context);
   } else {
     self->texture_update_callback(texture_id, self->width, self->height,
+                                  self->width, self->height, 1.0,
+                                  kVideoOutputNoCrop,
                                   self->texture_update_callback_context);
   }
 }
@@ -340,131 +1252,354 @@ void video_output_set_size(VideoOutput* self, gint64 width, gint64 height) {
   if (self->texture_gl) {
     self->width = width;
     self->height = height;
+    // Re-render the current frame at new dimensions, even if paused.
+    render_thread_request_render(self->render_thread, video_output_render,
+                                 self);
   }
+#ifdef MPV_RENDER_API_TYPE_SW
   // S/W
   if (self->texture_sw) {
-    self->width = CLAMP(width, 0, SW_RENDERING_MAX_WIDTH);
-    self->height = CLAMP(height, 0, SW_RENDERING_MAX_HEIGHT);
+    // Capped to |sw_max_width| x |sw_max_height| when rendering.
+    self->width = width;
+    self->height = height;
+    if (self->sw_render_thread != NULL) {
+      render_thread_request_render(self->sw_render_thread,
+                                   video_output_render_sw, self);
+    }
   }
+#endif
+  // The crop has no effect with a fixed size.
+  video_output_apply_crop_sync(self);
+}
+
+void video_output_set_visible(VideoOutput* self, gboolean visible) {
+  if (g_atomic_int_get(&self->visible) == visible) {
+    return;
+  }
+  g_atomic_int_set(&self->visible, visible);
+  if (!visible) {
+    return;
+  }
+  // H/W
+  if (self->texture_gl) {
+    render_thread_request_render(self->render_thread, video_output_render,
+                                 self);
+  }
+#ifdef MPV_RENDER_API_TYPE_SW
+  // S/W
+  if (self->texture_sw && self->sw_render_thread != NULL) {
+    render_thread_request_render(self->sw_render_thread,
+                                 video_output_render_sw, self);
+  }
+#endif
+}
+
+void video_output_set_display_size(VideoOutput* self,
+                                   gint64 width,
+                                   gint64 height) {
+  if (self->display_width == width && self->display_height == height) {
+    return;
+  }
+  self->display_width = width;
+  self->display_height = height;
+  // H/W
+  if (self->texture_gl) {
+    // Re-render the current frame at new dimensions, even if paused.
+    render_thread_request_render(self->render_thread, video_output_render,
+                                 self);
+  }
+#ifdef MPV_RENDER_API_TYPE_SW
+  // S/W
+  if (self->texture_sw && self->sw_render_thread != NULL) {
+    render_thread_request_render(self->sw_render_thread,
+                                 video_output_render_sw, self);
+  }
+#endif
+}
+
+void video_output_set_crop(VideoOutput* self, VideoOutputCrop crop) {
+  crop.left = CLAMP(crop.left, 0.0, 1.0);
+  crop.top = CLAMP(crop.top, 0.0, 1.0);
+  crop.width = CLAMP(crop.width, 0.0, 1.0 - crop.left);
+  crop.height = CLAMP(crop.height, 0.0, 1.0 - crop.top);
+  if (crop.width <= 0.0 || crop.height <= 0.0) {
+    crop = kVideoOutputNoCrop;
+  }
+  g_mutex_lock(&self->dimensions_mutex);
+  gboolean changed = !video_output_crop_equal(self->crop, crop);
+  self->crop = crop;
+  g_mutex_unlock(&self->dimensions_mutex);
+  if (!changed) {
+    return;
+  }
+  video_output_apply_crop_sync(self);
+  // Re-render the current frame with the new crop, even if paused.
+  video_output_request_render(self);
+}
+
+VideoOutputCrop video_output_get_crop(VideoOutput* self) {
+  if (self->width) {
+    // Fixed width & height.
+    return kVideoOutputNoCrop;
+  }
+  g_mutex_lock(&self->dimensions_mutex);
+  VideoOutputCrop crop = self->applied_crop;
+  g_mutex_unlock(&self->dimensions_mutex);
+  return crop;
+}
+
+gboolean video_output_crop_equal(VideoOutputCrop a, VideoOutputCrop b) {
+  return a.left == b.left && a.top == b.top && a.width == b.width &&
+         a.height == b.height;
 }
 
 mpv_render_context* video_output_get_render_context(VideoOutput* self) {
   return self->render_context;
 }
 
-EGLDisplay video_output_get_egl_display(VideoOutput* self) {
-  return self->egl_display;
+VideoOutputConfiguration video_output_get_configuration(VideoOutput* self) {
+  return self->configuration;
 }
 
-EGLContext video_output_get_egl_context(VideoOutput* self) {
-  return self->egl_context;
+FrameLatency* video_output_get_frame_latency(VideoOutput* self) {
+  return self->frame_latency;
 }
 
-EGLSurface video_output_get_egl_surface(VideoOutput* self) {
-  return self->egl_surface;
+gint64 video_output_create_mirror(VideoOutput* self) {
+  // H/W
+  if (self->texture_gl == NULL) {
+    return -1;
+  }
+  TextureGL* mirror = texture_gl_new_mirror(self->texture_gl);
+  if (mirror == NULL) {
+    return -1;
+  }
+  if (!fl_texture_registrar_register_texture(self->texture_registrar,
+                                             FL_TEXTURE(mirror))) {
+    g_object_unref(mirror);
+    return -1;
+  }
+  g_ptr_array_add(self->mirrors, mirror);
+  // Show the current frame right away.
+  fl_texture_registrar_mark_texture_frame_available(self->texture_registrar,
+                                                    FL_TEXTURE(mirror));
+  return (gint64)mirror;
 }
 
-guint8* video_output_get_pixel_buffer(VideoOutput* self) {
-  return self->pixel_buffer;
+void video_output_dispose_mirror(VideoOutput* self, gint64 id) {
+  for (guint i = 0; i < self->mirrors->len; i++) {
+    gpointer mirror = g_ptr_array_index(self->mirrors, i);
+    if ((gint64)mirror == id) {
+      fl_texture_registrar_unregister_texture(self->texture_registrar,
+                                              FL_TEXTURE(mirror));
+      g_ptr_array_remove_index(self->mirrors, i);
+      return;
+    }
+  }
 }
 
-gint64 video_output_get_width(VideoOutput* self) {
-  // Fixed width.
-  if (self->width) {
-    return self->width;
+MediaKitVideoDmaBufExportResult video_output_set_dma_buf_frame_callback(
+    VideoOutput* self,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context) {
+  // H/W
+  if (self->texture_gl &&
+      texture_gl_set_dma_buf_frame_callback(self->texture_gl, callback,
+                                            context)) {
+    return MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_OK;
+  }
+  return MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_NOT_SUPPORTED;
+}
+
+void video_output_release_dma_buf_frame(VideoOutput* self, guint64 id) {
+  // H/W
+  if (self->texture_gl != NULL) {
+    texture_gl_release_dma_buf_frame(self->texture_gl, id);
   }
+}
 
-  // Video resolution dependent width.
-  gint64 width = 0;
-  gint64 height = 0;
+MediaKitVideoFrameTapResult video_output_set_frame_tap_callback(
+    VideoOutput* self,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context) {
+  // H/W
+  if (self->texture_gl &&
+      texture_gl_set_frame_tap_callback(self->texture_gl, configuration,
+                                        callback, context)) {
+    return MEDIA_KIT_VIDEO_FRAME_TAP_OK;
+  }
+  return MEDIA_KIT_VIDEO_FRAME_TAP_NOT_SUPPORTED;
+}
 
-  mpv_node params;
-  mpv_get_property(self->handle, "video-out-params", MPV_FORMAT_NODE, &params);
+gdouble video_output_get_video_pts(VideoOutput* self) {
+  gdouble pts = -1.0;
+  if (mpv_get_property(self->handle, "video-pts", MPV_FORMAT_DOUBLE, &pts) <
+      0) {
+    return -1.0;
+  }
+  return pts;
+}
 
-  int64_t dw = 0, dh = 0, rotate = 0;
-  if (params.format == MPV_FORMAT_NODE_MAP) {
-    for (int32_t i = 0; i < params.u.list->num; i++) {
-      char* key = params.u.list->keys[i];
-      auto value = params.u.list->values[i];
-      if (value.format == MPV_FORMAT_INT64) {
-        if (strcmp(key, "dw") == 0) {
-          dw = value.u.int64;
-        }
-        if (strcmp(key, "dh") == 0) {
-          dh = value.u.int64;
-        }
-        if (strcmp(key, "rotate") == 0) {
-          rotate = value.u.int64;
-        }
-      }
-    }
-    mpv_free_node_contents(&params);
+EGLDisplay video_output_get_egl_display(VideoOutput* self) {
+  return self->egl_display;
+}
+
+EGLContext video_output_get_egl_context(VideoOutput* self) {
+  if (self->render_thread == NULL) {
+    return EGL_NO_CONTEXT;
   }
+  return render_thread_get_egl_context(self->render_thread);
+}
 
-  width = rotate == 0 || rotate == 180 ? dw : dh;
-  height = rotate == 0 || rotate == 180 ? dh : dw;
+RenderThread* video_output_get_render_thread(VideoOutput* self) {
+  return self->render_thread;
+}
 
-  if (self->texture_sw != NULL) {
-    // Make sure |width| & |height| fit between |SW_RENDERING_MAX_WIDTH| &
-    // |SW_RENDERING_MAX_HEIGHT| while maintaining aspect ratio.
-    if (width >= SW_RENDERING_MAX_WIDTH) {
-      return SW_RENDERING_MAX_WIDTH;
-    }
-    if (height >= SW_RENDERING_MAX_HEIGHT) {
-      return width / height * SW_RENDERING_MAX_HEIGHT;
+void video_output_add_frame_callback(VideoOutput* self,
+                                     RenderThreadCallback callback,
+                                     gpointer context) {
+  VideoOutputFrameCallback frame_callback{callback, context};
+  g_array_append_val(self->frame_callbacks, frame_callback);
+}
+
+void video_output_remove_frame_callback(VideoOutput* self,
+                                        RenderThreadCallback callback,
+                                        gpointer context) {
+  for (guint i = 0; i < self->frame_callbacks->len; i++) {
+    VideoOutputFrameCallback* frame_callback =
+        &g_array_index(self->frame_callbacks, VideoOutputFrameCallback, i);
+    if (frame_callback->callback == callback &&
+        frame_callback->context == context) {
+      g_array_remove_index(self->frame_callbacks, i);
+      return;
     }
   }
-
-  return width;
 }
 
-gint64 video_output_get_height(VideoOutput* self) {
-  // Fixed height.
-  if (self->width) {
-    return self->height;
+gboolean video_output_get_frame(VideoOutput* self,
+                                guint32* fbo,
+                                guint32* width,
+                                guint32* height,
+                                guint64* serial) {
+  // H/W
+  if (self->texture_gl == NULL) {
+    return FALSE;
   }
+  return texture_gl_get_frame(self->texture_gl, fbo, width, height, serial);
+}
 
-  // Video resolution dependent height.
-  gint64 width = 0;
-  gint64 height = 0;
+EGLSurface video_output_get_egl_surface(VideoOutput* self) {
+  return self->egl_surface;
+}
 
-  mpv_node params;
-  mpv_get_property(self->handle, "video-out-params", MPV_FORMAT_NODE, &params);
+gboolean video_output_acquire_pixel_buffer(VideoOutput* self,
+                                           const guint8** data,
+                                           gint64* width,
+                                           gint64* height,
+                                           VideoOutputCrop* crop) {
+  // Take the newest complete frame, releasing the previously held one.
+  gint state, latest;
+  do {
+    state = g_atomic_int_get(&self->pixel_buffer_state);
+    latest = VIDEO_OUTPUT_PIXEL_BUFFER_LATEST(state);
+    if (latest == -1) {
+      return FALSE;
+    }
+  } while (!g_atomic_int_compare_and_exchange(
+      &self->pixel_buffer_state, state,
+      VIDEO_OUTPUT_PIXEL_BUFFER_STATE(latest, latest)));
+  VideoOutputPixelBuffer* pixel_buffer = &self->pixel_buffers[latest];
+  *data = pixel_buffer->data;
+  *width = pixel_buffer->width;
+  *height = pixel_buffer->height;
+  *crop = pixel_buffer->crop;
+  return TRUE;
+}
 
-  int64_t dw = 0, dh = 0, rotate = 0;
-  if (params.format == MPV_FORMAT_NODE_MAP) {
-    for (int32_t i = 0; i < params.u.list->num; i++) {
-      char* key = params.u.list->keys[i];
-      auto value = params.u.list->values[i];
-      if (value.format == MPV_FORMAT_INT64) {
-        if (strcmp(key, "dw") == 0) {
-          dw = value.u.int64;
-        }
-        if (strcmp(key, "dh") == 0) {
-          dh = value.u.int64;
-        }
-        if (strcmp(key, "rotate") == 0) {
-          rotate = value.u.int64;
-        }
-      }
+static void video_output_get_dimensions(VideoOutput* self,
+                                        gint64* width,
+                                        gint64* height) {
+  if (self->width) {
+    // Fixed width & height.
+    *width = self->width;
+    *height = self->height;
+  } else {
+    // Video resolution dependent width & height.
+    video_output_update_video_dimensions(self);
+    g_mutex_lock(&self->dimensions_mutex);
+    *width = self->video_width;
+    *height = self->video_height;
+    VideoOutputCrop crop = self->applied_crop;
+    g_mutex_unlock(&self->dimensions_mutex);
+
+    // Only the visible region is rendered.
+    if (*width > 0 && *height > 0) {
+      *width = MAX((gint64)(*width * crop.width + 0.5), 1);
+      *height = MAX((gint64)(*height * crop.height + 0.5), 1);
     }
-    mpv_free_node_contents(&params);
   }
 
-  width = rotate == 0 || rotate == 180 ? dw : dh;
-  height = rotate == 0 || rotate == 180 ? dh : dw;
-
-  if (self->texture_sw != NULL) {
-    // Make sure |width| & |height| fit between |SW_RENDERING_MAX_WIDTH| &
-    // |SW_RENDERING_MAX_HEIGHT| while maintaining aspect ratio.
-    if (height >= SW_RENDERING_MAX_HEIGHT) {
-      return SW_RENDERING_MAX_HEIGHT;
+  // S/W: Fit within the configured maximum resolution, while maintaining
+  // aspect ratio.
+  if (self->texture_sw != NULL && *width > 0 && *height > 0) {
+    gdouble scale =
+        MIN((gdouble)self->configuration.sw_max_width / *width,
+            (gdouble)self->configuration.sw_max_height / *height);
+    if (scale < 1.0) {
+      *width = MAX((gint64)(*width * scale + 0.5), 1);
+      *height = MAX((gint64)(*height * scale + 0.5), 1);
     }
-    if (width >= SW_RENDERING_MAX_WIDTH) {
-      return height / width * SW_RENDERING_MAX_WIDTH;
+  }
+
+  // Do not render at a larger size than the one at which the video output is
+  // displayed, while maintaining aspect ratio.
+  if (self->display_width > 0 && self->display_height > 0 && *width > 0 &&
+      *height > 0) {
+    gdouble scale = MIN((gdouble)self->display_width / *width,
+                        (gdouble)self->display_height / *height);
+    if (scale < 1.0) {
+      *width = MAX((gint64)(*width * scale + 0.5), 1);
+      *height = MAX((gint64)(*height * scale + 0.5), 1);
     }
   }
 
+  // Dynamic resolution scaling.
+  gdouble scale = kVideoOutputScales[g_atomic_int_get(&self->scale_index)];
+  if (scale < 1.0 && *width > 0 && *height > 0) {
+    *width = MAX((gint64)(*width * scale + 0.5), 1);
+    *height = MAX((gint64)(*height * scale + 0.5), 1);
+  }
+
+  // Memory budget: Scale down (maintaining aspect ratio) until the render
+  // targets fit.
+  guint64 budget = (guint64)self->configuration.memory_budget;
+  VideoOutputFormat format = self->configuration.format;
+  if (budget > 0 && self->texture_gl != NULL && *width > 0 && *height > 0 &&
+      texture_gl_estimate_memory(format, *width, *height) > budget) {
+    gint64 unbudgeted_width = *width;
+    gint64 unbudgeted_height = *height;
+    gdouble budget_scale =
+        sqrt((gdouble)budget /
+             texture_gl_estimate_memory(format, *width, *height));
+    do {
+      *width = MAX((gint64)(unbudgeted_width * budget_scale + 0.5), 1);
+      *height = MAX((gint64)(unbudgeted_height * budget_scale + 0.5), 1);
+      budget_scale *= 0.9;
+    } while (texture_gl_estimate_memory(format, *width, *height) > budget &&
+             (*width > 1 || *height > 1));
+  }
+}
+
+gint64 video_output_get_width(VideoOutput* self) {
+  gint64 width = 0, height = 0;
+  video_output_get_dimensions(self, &width, &height);
+  return width;
+}
+
+gint64 video_output_get_height(VideoOutput* self) {
+  gint64 width = 0, height = 0;
+  video_output_get_dimensions(self, &width, &height);
   return height;
 }
 
@@ -481,12 +1616,175 @@ gint64 video_output_get_texture_id(VideoOutput* self) {
   return -1;
 }
 
-void video_output_notify_texture_update(VideoOutput* self) {
+void video_output_set_memory(VideoOutput* self, guint64 memory) {
+  g_mutex_lock(&video_output_memory_mutex);
+  video_output_memory = video_output_memory - self->memory + memory;
+  video_output_memory_high_water_mark =
+      MAX(video_output_memory_high_water_mark, video_output_memory);
+  self->memory = memory;
+  g_mutex_unlock(&video_output_memory_mutex);
+}
+
+guint64 video_output_get_memory(VideoOutput* self) {
+  g_mutex_lock(&video_output_memory_mutex);
+  guint64 memory = self->memory;
+  g_mutex_unlock(&video_output_memory_mutex);
+  return memory;
+}
+
+void video_output_get_process_memory(guint64* memory,
+                                     guint64* high_water_mark) {
+  g_mutex_lock(&video_output_memory_mutex);
+  *memory = video_output_memory;
+  *high_water_mark = video_output_memory_high_water_mark;
+  g_mutex_unlock(&video_output_memory_mutex);
+}
+
+FlValue* video_output_get_statistics(VideoOutput* self) {
+  FlValue* statistics = fl_value_new_map();
+  fl_value_set_string_take(statistics, "width",
+                           fl_value_new_int(video_output_get_width(self)));
+  fl_value_set_string_take(statistics, "height",
+                           fl_value_new_int(video_output_get_height(self)));
+  fl_value_set_string_take(statistics, "displayWidth",
+                           fl_value_new_int(self->display_width));
+  fl_value_set_string_take(statistics, "displayHeight",
+                           fl_value_new_int(self->display_height));
+  fl_value_set_string_take(statistics, "hardwareAcceleration",
+                           fl_value_new_bool(self->texture_gl != NULL));
+  fl_value_set_string_take(statistics, "renderBudget",
+                           fl_value_new_int(self->configuration.render_budget));
+  fl_value_set_string_take(
+      statistics, "scale",
+      fl_value_new_float(
+          kVideoOutputScales[g_atomic_int_get(&self->scale_index)]));
+  fl_value_set_string_take(
+      statistics, "scaleChanges",
+      fl_value_new_int(self->scale_changes.load(std::memory_order_relaxed)));
+  fl_value_set_string_take(statistics, "visible",
+                           fl_value_new_bool(g_atomic_int_get(&self->visible)));
+  fl_value_set_string_take(
+      statistics, "suspendedFrames",
+      fl_value_new_int(self->suspended_frames.load(std::memory_order_relaxed)));
+  fl_value_set_string_take(statistics, "framePacing",
+                           fl_value_new_bool(self->configuration.frame_pacing));
+  fl_value_set_string_take(
+      statistics, "refreshRate",
+      fl_value_new_float((gdouble)G_USEC_PER_SEC / self->refresh_interval));
+  fl_value_set_string_take(
+      statistics, "deferredRenders",
+      fl_value_new_int(self->deferred_renders.load(std::memory_order_relaxed)));
+  fl_value_set_string_take(statistics, "maxFps",
+                           fl_value_new_float(self->configuration.max_fps));
+  fl_value_set_string_take(
+      statistics, "cappedFrames",
+      fl_value_new_int(self->capped_frames.load(std::memory_order_relaxed)));
+  // Frames rendered per second over the last window of at least a second, 0
+  // if none was rendered since (e.g. paused).
+  gint64 fps_window_start =
+      self->fps_window_start.load(std::memory_order_relaxed);
+  fl_value_set_string_take(
+      statistics, "fps",
+      fl_value_new_float(fps_window_start > 0 &&
+                                 g_get_monotonic_time() - fps_window_start <
+                                     2 * G_USEC_PER_SEC
+                             ? self->fps.load(std::memory_order_relaxed)
+                             : 0.0));
+  g_mutex_lock(&self->pacing_mutex);
+  fl_value_set_string_take(statistics, "presentedFrames",
+                           fl_value_new_int(self->presented_frames));
+  fl_value_set_string_take(statistics, "lateFrames",
+                           fl_value_new_int(self->late_frames));
+  fl_value_set_string_take(statistics, "judderFrames",
+                           fl_value_new_int(self->judder_frames));
+  g_mutex_unlock(&self->pacing_mutex);
+  fl_value_set_string_take(statistics, "memory",
+                           fl_value_new_int(video_output_get_memory(self)));
+  fl_value_set_string_take(statistics, "memoryBudget",
+                           fl_value_new_int(self->configuration.memory_budget));
+  fl_value_set_string_take(statistics, "prewarmed",
+                           fl_value_new_bool(self->prewarmed));
+  fl_value_set_string_take(statistics, "createTime",
+                           fl_value_new_int(self->create_time));
+  g_mutex_lock(&self->pacing_mutex);
+  fl_value_set_string_take(statistics, "firstFrameTime",
+                           fl_value_new_int(self->first_frame_time));
+  g_mutex_unlock(&self->pacing_mutex);
+  fl_value_set_string_take(
+      statistics, "averageRenderTime",
+      fl_value_new_int(
+          (gint64)self->render_time.load(std::memory_order_relaxed)));
+  // S/W: Time spent on the GTK main thread per frame.
+  g_mutex_lock(&self->sw_mark_mutex);
+  fl_value_set_string_take(statistics, "mainThreadFrames",
+                           fl_value_new_int(self->main_thread_frames));
+  fl_value_set_string_take(
+      statistics, "averageMainThreadTime",
+      fl_value_new_int(self->main_thread_frames > 0
+                           ? self->main_thread_time /
+                                 (gint64)self->main_thread_frames
+                           : 0));
+  g_mutex_unlock(&self->sw_mark_mutex);
+  fl_value_set_string_take(
+      statistics, "sharedRenderThread",
+      fl_value_new_bool(self->configuration.shared_render_thread &&
+                        self->render_thread != NULL));
+  // H/W
+  if (self->texture_gl) {
+    texture_gl_get_statistics(self->texture_gl, statistics);
+    render_thread_get_statistics(self->render_thread, statistics);
+  }
+  return statistics;
+}
+
+FlValue* video_output_get_frame_latency_statistics(VideoOutput* self) {
+  return frame_latency_get_statistics(self->frame_latency);
+}
+
+void video_output_notify_present(VideoOutput* self, gint64 target_time) {
+  video_output_record_first_frame(self);
+  if (!self->configuration.frame_pacing || self->render_context == NULL ||
+      self->texture_gl == NULL) {
+    return;
+  }
+  // Lets mpv's display-sync & frame timing know when frames are presented.
+  mpv_render_context_report_swap(self->render_context);
+  gint64 now = mpv_get_time_us(self->handle);
+  g_mutex_lock(&self->pacing_mutex);
+  self->presented_frames++;
+  if (target_time > 0) {
+    // Presented a refresh interval (or more) after the target time.
+    if (now - target_time >= self->refresh_interval) {
+      self->late_frames++;
+    }
+    // Interval between presentations deviates from the interval between
+    // target times i.e. inconsistent cadence.
+    if (self->last_target_time > 0 &&
+        ABS((now - self->last_present_time) -
+            (target_time - self->last_target_time)) >
+            self->refresh_interval / 2) {
+      self->judder_frames++;
+    }
+    self->last_present_time = now;
+    self->last_target_time = target_time;
+  } else {
+    self->last_present_time = 0;
+    self->last_target_time = 0;
+  }
+  g_mutex_unlock(&self->pacing_mutex);
+}
+
+void video_output_notify_texture_update(VideoOutput* self,
+                                        gint64 width,
+                                        gint64 height,
+                                        gint64 texture_width,
+                                        gint64 texture_height,
+                                        VideoOutputCrop crop) {
   gint64 id = video_output_get_texture_id(self);
-  gint64 width = video_output_get_width(self);
-  gint64 height = video_output_get_height(self);
   gpointer context = self->texture_update_callback_context;
   if (self->texture_update_callback != NULL) {
-    self->texture_update_callback(id, width, height, context);
+    gdouble scale = kVideoOutputScales[g_atomic_int_get(&self->scale_index)];
+    self->texture_update_callback(id, width, height, texture_width,
+                                  texture_height, scale, crop, context);
   }
 }
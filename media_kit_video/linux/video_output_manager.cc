@@ -7,12 +7,33 @@
 // LICENSE file.
 
 #include "include/media_kit_video/video_output_manager.h"
+#include "include/media_kit_video/pixel_buffer_pool.h"
+#include "include/media_kit_video/texture_gl.h"
+#include "include/media_kit_video/texture_sw.h"
+
+// Video resolution assumed when estimating the memory required by a new
+// |VideoOutput| without fixed dimensions.
+#define VIDEO_OUTPUT_MANAGER_ESTIMATE_WIDTH 1920
+#define VIDEO_OUTPUT_MANAGER_ESTIMATE_HEIGHT 1080
+
+// Upper bound of |video_output_manager_set_pool_size|. Each pre-warmed entry
+// holds a thread & an EGL context.
+#define VIDEO_OUTPUT_MANAGER_MAX_POOL_SIZE 8
 
 struct _VideoOutputManager {
   GObject parent_instance;
   GHashTable* video_outputs;
   FlTextureRegistrar* texture_registrar;
   FlView* view;
+  RenderThread* render_thread; /* Shared by |VideoOutput|s opting into it. */
+  GHashTable* mosaics;         /* |TextureMosaic|s by texture ID. */
+  guint64 memory_limit;        /* Bytes. 0 i.e. unlimited. */
+  VideoOutputMemoryLimitPolicy memory_limit_policy;
+  GPtrArray* pool;             /* |VideoOutputPrewarmed|s. */
+  guint pool_size;
+  guint pool_source;           /* Pending refill (idle source) or 0. */
+  EGLDisplay egl_display;      /* Flutter's, used to fill |pool|. */
+  EGLConfig egl_config;
 };
 
 G_DEFINE_TYPE(VideoOutputManager, video_output_manager, G_TYPE_OBJECT)
@@ -20,11 +41,104 @@ G_DEFINE_TYPE(VideoOutputManager, video_output_manager, G_TYPE_OBJECT)
 static void video_output_manager_init(VideoOutputManager* self) {
   self->video_outputs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
                                               nullptr, g_object_unref);
+  self->render_thread = nullptr;
+  self->mosaics = g_hash_table_new_full(g_direct_hash, g_direct_equal, nullptr,
+                                        g_object_unref);
+  self->memory_limit = 0;
+  self->memory_limit_policy = VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_REJECT;
+  self->pool = g_ptr_array_new();
+  self->pool_size = 0;
+  self->pool_source = 0;
+  self->egl_display = EGL_NO_DISPLAY;
+  self->egl_config = NULL;
+}
+
+// Releases the members of |prewarmed| which were not adopted by a
+// |VideoOutput| & frees it.
+static void video_output_manager_release_prewarmed(
+    VideoOutputManager* self,
+    VideoOutputPrewarmed* prewarmed) {
+  if (prewarmed->texture_gl != NULL) {
+    fl_texture_registrar_unregister_texture(
+        self->texture_registrar, FL_TEXTURE(prewarmed->texture_gl));
+    g_clear_object(&prewarmed->texture_gl);
+  }
+  g_clear_object(&prewarmed->render_thread);
+  g_free(prewarmed);
+}
+
+// Trims or fills |pool| to |pool_size|. Filling requires Flutter's EGL
+// display & config, which are queried once (on the platform thread, while
+// Flutter's EGL context is current) & reused afterwards.
+static void video_output_manager_fill_pool(VideoOutputManager* self) {
+  while (self->pool->len > self->pool_size) {
+    video_output_manager_release_prewarmed(
+        self, (VideoOutputPrewarmed*)g_ptr_array_remove_index(
+                  self->pool, self->pool->len - 1));
+  }
+  if (self->pool->len == self->pool_size) {
+    return;
+  }
+  if (self->egl_config == NULL) {
+    EGLDisplay egl_display = eglGetCurrentDisplay();
+    EGLContext egl_context = eglGetCurrentContext();
+    if (egl_display == EGL_NO_DISPLAY || egl_context == EGL_NO_CONTEXT) {
+      return;
+    }
+    self->egl_config =
+        video_output_get_flutter_egl_config(egl_display, egl_context);
+    self->egl_display = egl_display;
+  }
+  if (self->egl_config == NULL) {
+    return;
+  }
+  while (self->pool->len < self->pool_size) {
+    // The isolated EGL context is created right away & made current on the
+    // render thread i.e. before any |VideoOutput| adopts it.
+    RenderThread* render_thread =
+        render_thread_new(self->egl_display, self->egl_config);
+    if (render_thread_get_egl_context(render_thread) == EGL_NO_CONTEXT) {
+      g_object_unref(render_thread);
+      break;
+    }
+    VideoOutputPrewarmed* prewarmed = g_new0(VideoOutputPrewarmed, 1);
+    prewarmed->render_thread = render_thread;
+    prewarmed->texture_gl = texture_gl_new_pooled(self->egl_display);
+    if (!fl_texture_registrar_register_texture(
+            self->texture_registrar, FL_TEXTURE(prewarmed->texture_gl))) {
+      g_clear_object(&prewarmed->texture_gl);
+    }
+    g_ptr_array_add(self->pool, prewarmed);
+  }
+}
+
+static gboolean video_output_manager_fill_pool_idle(gpointer data) {
+  VideoOutputManager* self = VIDEO_OUTPUT_MANAGER(data);
+  self->pool_source = 0;
+  video_output_manager_fill_pool(self);
+  return G_SOURCE_REMOVE;
 }
 
 static void video_output_manager_dispose(GObject* object) {
   VideoOutputManager* self = VIDEO_OUTPUT_MANAGER(object);
+  if (self->pool_source != 0) {
+    g_source_remove(self->pool_source);
+    self->pool_source = 0;
+  }
+  self->pool_size = 0;
+  video_output_manager_fill_pool(self);
+  g_ptr_array_unref(self->pool);
+  // Mosaics reference |VideoOutput|s (as tiles), dispose them first.
+  GHashTableIter iterator;
+  gpointer mosaic;
+  g_hash_table_iter_init(&iterator, self->mosaics);
+  while (g_hash_table_iter_next(&iterator, nullptr, &mosaic)) {
+    fl_texture_registrar_unregister_texture(self->texture_registrar,
+                                            FL_TEXTURE(mosaic));
+  }
+  g_hash_table_unref(self->mosaics);
   g_hash_table_unref(self->video_outputs);
+  g_clear_object(&self->render_thread);
   G_OBJECT_CLASS(video_output_manager_parent_class)->dispose(object);
 }
 
@@ -42,19 +156,157 @@ VideoOutputManager* video_output_manager_new(
   return video_output_manager;
 }
 
-void video_output_manager_create(VideoOutputManager* self,
-                                 gint64 handle,
-                                 VideoOutputConfiguration configuration,
-                                 TextureUpdateCallback texture_update_callback,
-                                 gpointer texture_update_callback_context) {
+// Bytes held by mosaic textures.
+static guint64 video_output_manager_get_mosaic_memory(
+    VideoOutputManager* self) {
+  guint64 memory = 0;
+  GHashTableIter iterator;
+  gpointer mosaic;
+  g_hash_table_iter_init(&iterator, self->mosaics);
+  while (g_hash_table_iter_next(&iterator, nullptr, &mosaic)) {
+    memory += texture_mosaic_get_memory(TEXTURE_MOSAIC(mosaic));
+  }
+  return memory;
+}
+
+// Estimates pixel buffers of a new S/W |VideoOutput| rendering a |width| x
+// |height| video, capped as per |configuration|.
+static guint64 video_output_manager_estimate_memory_sw(
+    VideoOutputConfiguration* configuration,
+    gint64 width,
+    gint64 height) {
+  gint64 max_width = configuration->sw_max_width > 0
+                         ? configuration->sw_max_width
+                         : SW_RENDERING_MAX_WIDTH;
+  gint64 max_height = configuration->sw_max_height > 0
+                          ? configuration->sw_max_height
+                          : SW_RENDERING_MAX_HEIGHT;
+  gdouble scale = MIN(1.0, MIN((gdouble)max_width / width,
+                               (gdouble)max_height / height));
+  width = MAX((gint64)(width * scale + 0.5), 1);
+  height = MAX((gint64)(height * scale + 0.5), 1);
+  return pixel_buffer_pool_get_capacity(4 * width * height) *
+         SW_RENDERING_PIXEL_BUFFER_COUNT;
+}
+
+// Applies the memory limit to |configuration| of a new |VideoOutput|. Returns
+// FALSE if it must be rejected.
+static gboolean video_output_manager_apply_memory_limit(
+    VideoOutputManager* self,
+    VideoOutputConfiguration* configuration) {
+  if (self->memory_limit == 0) {
+    return TRUE;
+  }
+  guint64 memory = 0, high_water_mark = 0;
+  video_output_get_process_memory(&memory, &high_water_mark);
+  memory += video_output_manager_get_mosaic_memory(self);
+  guint64 available =
+      self->memory_limit > memory ? self->memory_limit - memory : 0;
+  // The video's resolution is not known yet.
+  gint64 width = configuration->width > 0
+                     ? configuration->width
+                     : VIDEO_OUTPUT_MANAGER_ESTIMATE_WIDTH;
+  gint64 height = configuration->height > 0
+                      ? configuration->height
+                      : VIDEO_OUTPUT_MANAGER_ESTIMATE_HEIGHT;
+  guint64 required =
+      configuration->enable_hardware_acceleration
+          ? texture_gl_estimate_memory(configuration->format, width, height)
+          : video_output_manager_estimate_memory_sw(configuration, width,
+                                                    height);
+  if (required <= available) {
+    return TRUE;
+  }
+  if (self->memory_limit_policy == VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_DOWNSIZE &&
+      configuration->enable_hardware_acceleration &&
+      available >= texture_gl_estimate_memory(configuration->format, 1, 1)) {
+    configuration->memory_budget =
+        configuration->memory_budget > 0
+            ? MIN(configuration->memory_budget, (gint64)available)
+            : (gint64)available;
+    g_print(
+        "media_kit: VideoOutputManager: Memory limit: Video output downsized "
+        "to %" G_GINT64_FORMAT " bytes.\n",
+        configuration->memory_budget);
+    return TRUE;
+  }
+  if (self->memory_limit_policy == VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_DOWNSIZE &&
+      !configuration->enable_hardware_acceleration) {
+    // S/W: Lower the size cap (maintaining aspect ratio) until the pixel
+    // buffers fit.
+    VideoOutputConfiguration downsized = *configuration;
+    downsized.sw_max_width = downsized.sw_max_width > 0
+                                 ? downsized.sw_max_width
+                                 : SW_RENDERING_MAX_WIDTH;
+    downsized.sw_max_height = downsized.sw_max_height > 0
+                                  ? downsized.sw_max_height
+                                  : SW_RENDERING_MAX_HEIGHT;
+    while (video_output_manager_estimate_memory_sw(&downsized, width, height) >
+               available &&
+           (downsized.sw_max_width > 1 || downsized.sw_max_height > 1)) {
+      downsized.sw_max_width = MAX((gint64)(downsized.sw_max_width * 0.9), 1);
+      downsized.sw_max_height =
+          MAX((gint64)(downsized.sw_max_height * 0.9), 1);
+    }
+    if (video_output_manager_estimate_memory_sw(&downsized, width, height) <=
+        available) {
+      *configuration = downsized;
+      g_print(
+          "media_kit: VideoOutputManager: Memory limit: Video output downsized "
+          "to %" G_GINT64_FORMAT "x%" G_GINT64_FORMAT ".\n",
+          configuration->sw_max_width, configuration->sw_max_height);
+      return TRUE;
+    }
+  }
+  g_printerr(
+      "media_kit: VideoOutputManager: Memory limit: Video output rejected, "
+      "%" G_GUINT64_FORMAT " of %" G_GUINT64_FORMAT " bytes in use.\n",
+      memory, self->memory_limit);
+  return FALSE;
+}
+
+gboolean video_output_manager_create(
+    VideoOutputManager* self,
+    gint64 handle,
+    VideoOutputConfiguration configuration,
+    TextureUpdateCallback texture_update_callback,
+    gpointer texture_update_callback_context) {
   if (!g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    if (!video_output_manager_apply_memory_limit(self, &configuration)) {
+      return FALSE;
+    }
+    // Adopt pre-warmed resources, unless rendering on the shared render thread.
+    VideoOutputPrewarmed* prewarmed = nullptr;
+    if (configuration.enable_hardware_acceleration &&
+        !configuration.shared_render_thread && self->pool->len > 0) {
+      prewarmed = (VideoOutputPrewarmed*)g_ptr_array_remove_index(
+          self->pool, self->pool->len - 1);
+    }
     g_autoptr(VideoOutput) video_output = video_output_new(
-        self->texture_registrar, self->view, handle, configuration);
+        self->texture_registrar, self->view, handle, configuration,
+        configuration.shared_render_thread ? self->render_thread : nullptr,
+        prewarmed);
+    if (prewarmed != nullptr) {
+      video_output_manager_release_prewarmed(self, prewarmed);
+    }
+    // Refill once idle i.e. after the response is sent.
+    if (self->pool->len < self->pool_size && self->pool_source == 0) {
+      self->pool_source =
+          g_idle_add(video_output_manager_fill_pool_idle, self);
+    }
+    // The first |VideoOutput| opting into the shared render thread creates it.
+    RenderThread* render_thread =
+        video_output_get_render_thread(video_output);
+    if (configuration.shared_render_thread && self->render_thread == nullptr &&
+        render_thread != nullptr) {
+      self->render_thread = RENDER_THREAD(g_object_ref(render_thread));
+    }
     video_output_set_texture_update_callback(
         video_output, texture_update_callback, texture_update_callback_context);
     g_hash_table_insert(self->video_outputs, GINT_TO_POINTER(handle),
                         g_object_ref(video_output));
   }
+  return TRUE;
 }
 
 void video_output_manager_set_size(VideoOutputManager* self,
@@ -68,8 +320,258 @@ void video_output_manager_set_size(VideoOutputManager* self,
   }
 }
 
+void video_output_manager_set_display_size(VideoOutputManager* self,
+                                           gint64 handle,
+                                           gint64 width,
+                                           gint64 height) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    video_output_set_display_size(video_output, width, height);
+  }
+}
+
+void video_output_manager_set_crop(VideoOutputManager* self,
+                                   gint64 handle,
+                                   VideoOutputCrop crop) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    video_output_set_crop(video_output, crop);
+  }
+}
+
+FlValue* video_output_manager_get_statistics(VideoOutputManager* self,
+                                             gint64 handle) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    return video_output_get_statistics(video_output);
+  }
+  return fl_value_new_map();
+}
+
+FlValue* video_output_manager_get_frame_latency(VideoOutputManager* self,
+                                                gint64 handle) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    return video_output_get_frame_latency_statistics(video_output);
+  }
+  return fl_value_new_map();
+}
+
+void video_output_manager_set_visible(VideoOutputManager* self,
+                                      gint64 handle,
+                                      gboolean visible) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    video_output_set_visible(video_output, visible);
+  }
+}
+
+gint64 video_output_manager_create_mirror(VideoOutputManager* self,
+                                          gint64 handle) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    return video_output_create_mirror(video_output);
+  }
+  return -1;
+}
+
+void video_output_manager_dispose_mirror(VideoOutputManager* self,
+                                         gint64 handle,
+                                         gint64 id) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    video_output_dispose_mirror(video_output, id);
+  }
+}
+
+MediaKitVideoDmaBufExportResult
+video_output_manager_set_dma_buf_frame_callback(
+    VideoOutputManager* self,
+    gint64 handle,
+    MediaKitVideoDmaBufFrameCallback callback,
+    gpointer context) {
+  if (!g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    return MEDIA_KIT_VIDEO_DMA_BUF_EXPORT_NOT_FOUND;
+  }
+  VideoOutput* video_output = VIDEO_OUTPUT(
+      g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+  return video_output_set_dma_buf_frame_callback(video_output, callback,
+                                                 context);
+}
+
+void video_output_manager_release_dma_buf_frame(VideoOutputManager* self,
+                                                gint64 handle,
+                                                guint64 id) {
+  if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    video_output_release_dma_buf_frame(video_output, id);
+  }
+}
+
+MediaKitVideoFrameTapResult video_output_manager_set_frame_tap_callback(
+    VideoOutputManager* self,
+    gint64 handle,
+    const MediaKitVideoFrameTapConfiguration* configuration,
+    MediaKitVideoFrameTapCallback callback,
+    gpointer context) {
+  if (!g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    return MEDIA_KIT_VIDEO_FRAME_TAP_NOT_FOUND;
+  }
+  VideoOutput* video_output = VIDEO_OUTPUT(
+      g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+  return video_output_set_frame_tap_callback(video_output, configuration,
+                                             callback, context);
+}
+
+gint64 video_output_manager_create_mosaic(VideoOutputManager* self,
+                                          gint64 width,
+                                          gint64 height) {
+  g_autoptr(TextureMosaic) mosaic =
+      texture_mosaic_new(self->texture_registrar, width, height);
+  if (!fl_texture_registrar_register_texture(self->texture_registrar,
+                                             FL_TEXTURE(mosaic))) {
+    return -1;
+  }
+  gint64 id = (gint64)mosaic;
+  g_hash_table_insert(self->mosaics, GINT_TO_POINTER(id),
+                      g_object_ref(mosaic));
+  return id;
+}
+
+guint video_output_manager_set_mosaic_layout(VideoOutputManager* self,
+                                             gint64 id,
+                                             const gint64* handles,
+                                             const TextureMosaicRect* rects,
+                                             guint count,
+                                             gint64* rejected) {
+  if (!g_hash_table_contains(self->mosaics, GINT_TO_POINTER(id))) {
+    return 0;
+  }
+  TextureMosaic* mosaic =
+      TEXTURE_MOSAIC(g_hash_table_lookup(self->mosaics, GINT_TO_POINTER(id)));
+  g_autofree VideoOutput** video_outputs = g_new0(VideoOutput*, count);
+  g_autofree TextureMosaicRect* tile_rects = g_new0(TextureMosaicRect, count);
+  g_autofree gint64* tile_handles = g_new0(gint64, count);
+  g_autofree gboolean* tile_rejected = g_new0(gboolean, count);
+  guint tiles = 0;
+  for (guint i = 0; i < count; i++) {
+    if (g_hash_table_contains(self->video_outputs,
+                              GINT_TO_POINTER(handles[i]))) {
+      VideoOutput* video_output = VIDEO_OUTPUT(g_hash_table_lookup(
+          self->video_outputs, GINT_TO_POINTER(handles[i])));
+      // Render tiles no larger than displayed.
+      video_output_set_display_size(video_output, rects[i].width,
+                                    rects[i].height);
+      video_outputs[tiles] = video_output;
+      tile_rects[tiles] = rects[i];
+      tile_handles[tiles] = handles[i];
+      tiles++;
+    }
+  }
+  guint rejected_count = texture_mosaic_set_layout(
+      mosaic, video_outputs, tile_rects, tiles, tile_rejected);
+  guint j = 0;
+  for (guint i = 0; i < tiles; i++) {
+    if (tile_rejected[i]) {
+      rejected[j++] = tile_handles[i];
+    }
+  }
+  return rejected_count;
+}
+
+FlValue* video_output_manager_get_mosaic_statistics(VideoOutputManager* self,
+                                                    gint64 id) {
+  FlValue* statistics = fl_value_new_map();
+  if (g_hash_table_contains(self->mosaics, GINT_TO_POINTER(id))) {
+    texture_mosaic_get_statistics(
+        TEXTURE_MOSAIC(g_hash_table_lookup(self->mosaics, GINT_TO_POINTER(id))),
+        statistics);
+  }
+  return statistics;
+}
+
+void video_output_manager_dispose_mosaic(VideoOutputManager* self, gint64 id) {
+  if (g_hash_table_contains(self->mosaics, GINT_TO_POINTER(id))) {
+    fl_texture_registrar_unregister_texture(
+        self->texture_registrar,
+        FL_TEXTURE(g_hash_table_lookup(self->mosaics, GINT_TO_POINTER(id))));
+    g_hash_table_remove(self->mosaics, GINT_TO_POINTER(id));
+  }
+}
+
+void video_output_manager_set_memory_limit(
+    VideoOutputManager* self,
+    guint64 limit,
+    VideoOutputMemoryLimitPolicy policy) {
+  self->memory_limit = limit;
+  self->memory_limit_policy = policy;
+}
+
+void video_output_manager_set_pool_size(VideoOutputManager* self,
+                                        guint size) {
+  self->pool_size = MIN(size, VIDEO_OUTPUT_MANAGER_MAX_POOL_SIZE);
+  video_output_manager_fill_pool(self);
+  g_print("media_kit: VideoOutputManager: %u pre-warmed render context(s).\n",
+          self->pool->len);
+}
+
+FlValue* video_output_manager_get_memory_statistics(VideoOutputManager* self) {
+  guint64 memory = 0, high_water_mark = 0;
+  video_output_get_process_memory(&memory, &high_water_mark);
+  guint64 mosaic_memory = video_output_manager_get_mosaic_memory(self);
+  FlValue* video_outputs = fl_value_new_map();
+  GHashTableIter iterator;
+  gpointer handle, video_output;
+  g_hash_table_iter_init(&iterator, self->video_outputs);
+  while (g_hash_table_iter_next(&iterator, &handle, &video_output)) {
+    fl_value_set_take(
+        video_outputs, fl_value_new_int((gint64)(gintptr)handle),
+        fl_value_new_int(video_output_get_memory(VIDEO_OUTPUT(video_output))));
+  }
+  FlValue* statistics = fl_value_new_map();
+  fl_value_set_string_take(statistics, "memory",
+                           fl_value_new_int(memory + mosaic_memory));
+  fl_value_set_string_take(statistics, "videoOutputMemory",
+                           fl_value_new_int(memory));
+  fl_value_set_string_take(statistics, "mosaicMemory",
+                           fl_value_new_int(mosaic_memory));
+  // Released S/W pixel buffers kept for reuse, not counted in "memory".
+  fl_value_set_string_take(statistics, "pixelBufferPool",
+                           pixel_buffer_pool_get_statistics());
+  // Process-wide i.e. of all |VideoOutput|s ever created.
+  fl_value_set_string_take(statistics, "highWaterMark",
+                           fl_value_new_int(high_water_mark));
+  fl_value_set_string_take(statistics, "limit",
+                           fl_value_new_int(self->memory_limit));
+  fl_value_set_string_take(
+      statistics, "limitPolicy",
+      fl_value_new_string(self->memory_limit_policy ==
+                                  VIDEO_OUTPUT_MEMORY_LIMIT_POLICY_DOWNSIZE
+                              ? "downsize"
+                              : "reject"));
+  fl_value_set_string_take(statistics, "videoOutputs", video_outputs);
+  return statistics;
+}
+
 void video_output_manager_dispose(VideoOutputManager* self, gint64 handle) {
   if (g_hash_table_contains(self->video_outputs, GINT_TO_POINTER(handle))) {
+    // Remove from mosaics, which do not keep their tiles alive.
+    VideoOutput* video_output = VIDEO_OUTPUT(
+        g_hash_table_lookup(self->video_outputs, GINT_TO_POINTER(handle)));
+    GHashTableIter iterator;
+    gpointer mosaic;
+    g_hash_table_iter_init(&iterator, self->mosaics);
+    while (g_hash_table_iter_next(&iterator, nullptr, &mosaic)) {
+      texture_mosaic_remove_video_output(TEXTURE_MOSAIC(mosaic), video_output);
+    }
     g_hash_table_remove(self->video_outputs, GINT_TO_POINTER(handle));
   }
 }
@@ -31,6 +31,21 @@ VideoOutput::VideoOutput(int64_t handle,
   // |ANGLESurfaceManager| & libmpv render context creation can conflict with
   // the existing |Render| or |Resize| calls from another |VideoOutput|
   // instances (which will result in access violation).
+  observer_ = mpv_create_weak_client(handle_, nullptr);
+  if (observer_ != nullptr) {
+    mpv_set_wakeup_callback(
+        observer_,
+        [](void* context) {
+          // No mpv API may be called from here. Events are drained lazily in
+          // |UpdateVideoDimensions|.
+          auto that = reinterpret_cast<VideoOutput*>(context);
+          that->observer_pending_ = true;
+        },
+        reinterpret_cast<void*>(this));
+    mpv_observe_property(observer_, 0, "video-out-params", MPV_FORMAT_NODE);
+  }
+  // Otherwise "video-out-params" is queried directly in
+  // |UpdateVideoDimensions|.
   auto future = thread_pool_ref_->Post([&]() {
     mpv_set_option_string(handle_, "video-sync", "audio");
     mpv_set_option_string(handle_, "video-timing-offset", "0");
@@ -109,6 +124,11 @@ VideoOutput::VideoOutput(int64_t handle,
 
 VideoOutput::~VideoOutput() {
   destroyed_ = true;
+  if (observer_ != nullptr) {
+    mpv_set_wakeup_callback(observer_, nullptr, nullptr);
+    mpv_destroy(observer_);
+    observer_ = nullptr;
+  }
   auto promise = std::promise<void>();
   if (texture_id_) {
     registrar_->texture_registrar()->UnregisterTexture(
@@ -372,32 +392,13 @@ int64_t VideoOutput::GetVideoWidth() {
   int64_t width = 0;
   int64_t height = 0;
 
-  mpv_node params;
-  mpv_get_property(handle_, "video-out-params", MPV_FORMAT_NODE, &params);
-
-  int64_t dw = 0, dh = 0, rotate = 0;
-  if (params.format == MPV_FORMAT_NODE_MAP) {
-    for (int32_t i = 0; i < params.u.list->num; i++) {
-      char* key = params.u.list->keys[i];
-      auto value = params.u.list->values[i];
-      if (value.format == MPV_FORMAT_INT64) {
-        if (strcmp(key, "dw") == 0) {
-          dw = value.u.int64;
-        }
-        if (strcmp(key, "dh") == 0) {
-          dh = value.u.int64;
-        }
-        if (strcmp(key, "rotate") == 0) {
-          rotate = value.u.int64;
-        }
-      }
-    }
-    mpv_free_node_contents(&params);
+  UpdateVideoDimensions();
+  {
+    std::lock_guard<std::mutex> lock(dimensions_mutex_);
+    width = video_width_;
+    height = video_height_;
   }
 
-  width = rotate == 0 || rotate == 180 ? dw : dh;
-  height = rotate == 0 || rotate == 180 ? dh : dw;
-
   if (pixel_buffer_ != nullptr) {
     // Make sure |width| & |height| fit between |SW_RENDERING_MAX_WIDTH| &
     // |SW_RENDERING_MAX_HEIGHT| while maintaining aspect-ratio.
@@ -421,14 +422,36 @@ int64_t VideoOutput::GetVideoHeight() {
   int64_t width = 0;
   int64_t height = 0;
 
-  mpv_node params;
-  mpv_get_property(handle_, "video-out-params", MPV_FORMAT_NODE, &params);
+  UpdateVideoDimensions();
+  {
+    std::lock_guard<std::mutex> lock(dimensions_mutex_);
+    width = video_width_;
+    height = video_height_;
+  }
 
+  if (pixel_buffer_ != NULL) {
+    // Make sure |width| & |height| fit between |SW_RENDERING_MAX_WIDTH| &
+    // |SW_RENDERING_MAX_HEIGHT| while maintaining aspect-ratio.
+    if (height >= SW_RENDERING_MAX_HEIGHT) {
+      return SW_RENDERING_MAX_HEIGHT;
+    }
+    if (width >= SW_RENDERING_MAX_WIDTH) {
+      return height / width * SW_RENDERING_MAX_WIDTH;
+    }
+  }
+
+  return height;
+}
+
+// Reads the (rotation applied) video dimensions from "video-out-params".
+static void ParseVideoOutParams(const mpv_node* params,
+                                int64_t* width,
+                                int64_t* height) {
   int64_t dw = 0, dh = 0, rotate = 0;
-  if (params.format == MPV_FORMAT_NODE_MAP) {
-    for (int32_t i = 0; i < params.u.list->num; i++) {
-      char* key = params.u.list->keys[i];
-      auto value = params.u.list->values[i];
+  if (params->format == MPV_FORMAT_NODE_MAP) {
+    for (int32_t i = 0; i < params->u.list->num; i++) {
+      char* key = params->u.list->keys[i];
+      auto value = params->u.list->values[i];
       if (value.format == MPV_FORMAT_INT64) {
         if (strcmp(key, "dw") == 0) {
           dw = value.u.int64;
@@ -441,22 +464,52 @@ int64_t VideoOutput::GetVideoHeight() {
         }
       }
     }
-    mpv_free_node_contents(&params);
   }
+  *width = rotate == 0 || rotate == 180 ? dw : dh;
+  *height = rotate == 0 || rotate == 180 ? dh : dw;
+}
 
-  width = rotate == 0 || rotate == 180 ? dw : dh;
-  height = rotate == 0 || rotate == 180 ? dh : dw;
-
-  if (pixel_buffer_ != NULL) {
-    // Make sure |width| & |height| fit between |SW_RENDERING_MAX_WIDTH| &
-    // |SW_RENDERING_MAX_HEIGHT| while maintaining aspect-ratio.
-    if (height >= SW_RENDERING_MAX_HEIGHT) {
-      return SW_RENDERING_MAX_HEIGHT;
+void VideoOutput::UpdateVideoDimensions() {
+  if (observer_ == nullptr) {
+    // No weak client could be created: Query the property every time.
+    mpv_node params;
+    int64_t width = 0, height = 0;
+    if (mpv_get_property(handle_, "video-out-params", MPV_FORMAT_NODE,
+                         &params) >= 0) {
+      ParseVideoOutParams(&params, &width, &height);
+      mpv_free_node_contents(&params);
     }
-    if (width >= SW_RENDERING_MAX_WIDTH) {
-      return height / width * SW_RENDERING_MAX_WIDTH;
+    std::lock_guard<std::mutex> lock(dimensions_mutex_);
+    video_width_ = width;
+    video_height_ = height;
+    return;
+  }
+  if (!observer_pending_.exchange(false)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(dimensions_mutex_);
+  while (true) {
+    auto event = mpv_wait_event(observer_, 0);
+    if (event->event_id == MPV_EVENT_NONE) {
+      break;
+    }
+    if (event->event_id == MPV_EVENT_SHUTDOWN) {
+      video_width_ = 0;
+      video_height_ = 0;
+      continue;
+    }
+    if (event->event_id != MPV_EVENT_PROPERTY_CHANGE) {
+      continue;
+    }
+    auto property = reinterpret_cast<mpv_event_property*>(event->data);
+    if (strcmp(property->name, "video-out-params") != 0) {
+      continue;
+    }
+    video_width_ = 0;
+    video_height_ = 0;
+    if (property->format == MPV_FORMAT_NODE) {
+      ParseVideoOutParams(reinterpret_cast<mpv_node*>(property->data),
+                          &video_width_, &video_height_);
     }
   }
-
-  return height;
 }
@@ -15,6 +15,7 @@
 #include <render.h>
 #include <render_gl.h>
 
+#include <atomic>
 #include <future>
 #include <memory>
 
@@ -89,11 +90,23 @@ class VideoOutput {
 
   int64_t GetVideoHeight();
 
+  // Drains |observer_|'s events & updates the cached video dimensions if
+  // "video-out-params" changed since the last call. Queries the property
+  // directly if no weak client could be created.
+  void UpdateVideoDimensions();
+
   std::optional<int64_t> height_ = std::nullopt;
   std::optional<int64_t> width_ = std::nullopt;
   VideoOutputConfiguration configuration_ = VideoOutputConfiguration{};
 
   mpv_handle* handle_ = nullptr;
+  // Weak client observing "video-out-params". Avoids querying the property on
+  // every |CheckAndResize|.
+  mpv_handle* observer_ = nullptr;
+  std::atomic<bool> observer_pending_ = false;
+  std::mutex dimensions_mutex_ = std::mutex();
+  int64_t video_width_ = 0;
+  int64_t video_height_ = 0;
   mpv_render_context* render_context_ = nullptr;
   int64_t texture_id_ = 0;
   flutter::PluginRegistrarWindows* registrar_ = nullptr;